@@ -34,14 +34,10 @@
 //   (although this would have bloated the code) hence the names being CAPS
 // A later release implemented debug output and so they needed to be converted
 //   to functions.
-// I tried to implement a dual-compile mode (DEBUG/non-DEBUG) but for some
-//   reason, no matter what I did I could not get them to function as macros again.
-// I have found a *lot* of bugs in the Arduino compiler over the last few weeks,
-//   and I am currently assuming that one of these bugs is my problem.
-// I may revisit this code at a later date and look at the assembler produced
-//   in a hope of finding out what is going on, but for now they will remain as
-//   functions even in non-DEBUG mode
+// Without DEBUG they are inline functions in IRremote.h; these reporting
+//   versions are only built with DEBUG
 //
+#if DEBUG
 int  MATCH (int measured,  int desired)
 {
  	DBG_PRINT(F("Testing: "));
@@ -110,19 +106,172 @@ int  MATCH_SPACE (int measured_ticks,  int desired_us)
     DBG_PRINTLN(F("?; FAILED")); 
  	return passed;
 }
+#endif // DEBUG
+
+//+=============================================================================
+// Hand the slot the ISR has just filled over to decode() and start on the next.
+// If every slot is still waiting to be decoded, park in STATE_STOP until
+// resume() releases one.
+// Only the ISR moves 'head' and only resume() moves 'tail', so neither side
+// needs to disable interrupts to look at the ring.
+// Relaying, the slot goes to the sender instead, which is then the one to
+// release it, in place of resume() [see IRrecv::relay()]; If it has no room,
+// the frame is dropped.
+//
+static void  publishSlot (uint8_t overflow)
+{
+	volatile irslot_t  *slot = &irparams.slot[IR_SLOT(irparams.head)];
+
+	slot->rawlen    = irparams.rawlen;
+	slot->overflow  = overflow;
+	irparams.rawlen = 0;
+	irparams.head++;
+
+#if IR_SEND_ASYNC
+	if (irsendparams.relay && !IRrelaySlot()) {
+		irparams.head--;
+		if (irparams.dropped < 255)  irparams.dropped++ ;
+	}
+#endif
+
+	if ((uint8_t)(irparams.head - irparams.tail) < IR_CAPTURE_SLOTS)  irparams.rcvstate = STATE_IDLE ;
+	else                                                               irparams.rcvstate = STATE_STOP ;
+}
+
+#if IR_RECV_STREAM
+//+=============================================================================
+// Does a duration fit a PROGMEM tick window
+//
+static inline bool  streamMatch (unsigned int ticks,  const irticks_t *window_P)
+{
+	return (ticks >= pgm_read_word(&window_P->lo)) && (ticks <= pgm_read_word(&window_P->hi));
+}
+
+//+=============================================================================
+// Check duration 'len' of the frame being captured against the locked protocol
+// The same checks as decodePulseDistance(), made as each duration arrives.
+// Returns true when it was the last MARK of a frame [or of a REPEAT]
+// The first duration that does not fit gives up on the frame; it then ends at
+//   the gap, as usual, and decode() looks at it.
+//
+static inline bool  streamTicks (uint8_t len,  unsigned int ticks)
+{
+	const irpulse_t  *p = irstream.proto;
+
+	if (len == 0) {  // The gap; A new frame
+		irstream.end  = irstream.framelen;
+		irstream.high = 0;
+		irstream.data = 0;
+		return false;
+	}
+	if (!irstream.end)  return false ;
+
+	if (len == 1) {  // Header mark
+		if (!streamMatch(ticks, &p->hdrMark))  irstream.end = 0 ;
+
+	} else if (len == 2) {  // Header space, or the space of a REPEAT
+		if (!streamMatch(ticks, &p->hdrSpace)) {
+			// A REPEAT is just hdrMark + rptSpace + bitFixed
+			if (pgm_read_word(&p->rptSpace.hi) && streamMatch(ticks, &p->rptSpace))  irstream.end = 4 ;
+			else                                                                     irstream.end = 0 ;
+		}
+
+	} else if (len & 1) {  // MARK of a bit, or the MARK that ends the frame
+		if (!streamMatch(ticks, &p->bitFixed))  irstream.end = 0 ;
+
+	} else {  // SPACE of a bit
+		irstream.high = (irstream.high << 1) | (irstream.data >> 31);
+		if      (streamMatch(ticks, &p->bitOne ))  irstream.data = (irstream.data << 1) | 1 ;
+		else if (streamMatch(ticks, &p->bitZero))  irstream.data = (irstream.data << 1) | 0 ;
+		else                                       irstream.end  = 0 ;
+	}
+
+	return (len + 1 == irstream.end);
+}
+#endif
+
+//+=============================================================================
+// Append one duration to the slot being captured
+// If the slot is already full, hand it over flagged as overflowed instead
+// When streaming, hand it over as soon as it holds a whole frame
+// Returns false if the slot was handed over
+//
+static inline bool  recordTicks (unsigned int ticks)
+{
+	uint8_t             len  = irparams.rawlen;
+	volatile irslot_t  *slot = &irparams.slot[IR_SLOT(irparams.head)];
+
+	if (len >= RAWBUF) {
+		publishSlot(true);
+		return false;
+	}
+#if IR_RECV_STREAM
+	bool  complete = false;
+
+	if (len == 0)        slot->streamed = false ;
+	if (irstream.proto)  complete = streamTicks(len, ticks) ;
+#endif
+	if (len == 0)  slot->stamp = millis() ;  // The gap is over; The first MARK has begun
+#if IR_COMPACT_RAWBUF
+	if (len == 0)  slot->rawlongs = 0 ;
+	if (ticks >= IR_RAW_ESCAPE) {
+		if (slot->rawlongs < IR_RAW_LONGS) {
+			slot->rawlong[slot->rawlongs] = ticks;
+			ticks = IR_RAW_ESCAPE + slot->rawlongs++;
+		} else {
+			ticks = IR_RAW_ESCAPE - 1;  // Out of escapes: clip, decoders only see "long"
+		}
+	}
+#endif
+	slot->rawbuf[len] = ticks;
+	irparams.rawlen = len + 1;
+
+#if IR_RECV_STREAM
+	if (complete) {
+		// Every bit is in; Don't wait for the gap
+		slot->streamed    = true;
+		slot->streamproto = irstream.proto;
+		slot->streamhigh  = irstream.high;
+		slot->streamdata  = irstream.data;
+		publishSlot(false);
+		return false;
+	}
+#endif
+	return true;
+}
+
+//+=============================================================================
+// While IRsend has the timer it runs as the carrier; The receiver counts its
+// periods in to ticks, and must not change its rate [IR_FULL_DUPLEX]
+//
+#if IR_RECV_SHARED && defined(TIMER_CARRIER_CLOCKS)
+#	define RECV_IDLE_TICKS     (irparams.lent ? 1 : TIMER_IDLE_TICKS)
+#	define RECV_CONFIG_IDLE()  do { if (!irparams.lent)  TIMER_CONFIG_IDLE() ; } while (0)
+#	define RECV_CONFIG_BUSY()  do { if (!irparams.lent)  TIMER_CONFIG_BUSY() ; } while (0)
+#else
+#	define RECV_IDLE_TICKS     TIMER_IDLE_TICKS
+#	define RECV_CONFIG_IDLE()  TIMER_CONFIG_IDLE()
+#	define RECV_CONFIG_BUSY()  TIMER_CONFIG_BUSY()
+#endif
 
 //+=============================================================================
 // Interrupt Service Routine - Fires every 50uS
 // TIMER2 interrupt code to collect raw data.
-// Widths of alternating SPACE, MARK are recorded in rawbuf.
+// Widths of alternating SPACE, MARK are recorded in the rawbuf of the current slot.
 // Recorded in ticks of 50uS [microseconds, 0.000050 seconds]
 // 'rawlen' counts the number of entries recorded so far.
 // First entry is the SPACE between transmissions.
 // As soon as a the first [SPACE] entry gets long:
-//   Ready is set; State switches to IDLE; Timing of SPACE continues.
+//   The slot is handed to decode(); State switches to IDLE; Timing of SPACE continues.
 // As soon as first MARK arrives:
-//   Gap width is recorded; Ready is cleared; New logging starts
+//   Gap width is recorded; New logging starts in the next free slot
+// This runs 20,000 times a second, so the timer and state are worked on in
+// locals and irparams (which is volatile) is only touched when something changes.
+// Between frames (IDLE, STOP) the timer may run TIMER_IDLE_TICKS times slower;
+// each interrupt then accounts for that many ticks.
+// While IRsend has the timer, it fires once per carrier period instead.
 //
+#if !IR_RECV_EDGE
 #ifdef IR_TIMER_USE_ESP32
 void IRTimer()
 #else
@@ -131,62 +280,176 @@ ISR (TIMER_INTR_NAME)
 {
 	TIMER_RESET;
 
+#if IR_SEND_ASYNC
+	// Sending : The timer is running at the carrier frequency, for IRsend
+	if (irsendparams.head != irsendparams.tail) {
+		IRsendTick();
+#	if !(IR_RECV_SHARED && defined(TIMER_CARRIER_CLOCKS))
+		return;
+#	endif
+	}
+#endif
+
+#if IR_RECV_SHARED && defined(TIMER_CARRIER_CLOCKS)
+	if (irparams.lent) {
+		if (!irparams.armed)  return ;  // Nobody listening
+
+		// Count carrier periods up to the next 50uS tick
+		irparams.clocks += TIMER_CARRIER_CLOCKS;
+		if (irparams.clocks < TIMER_COUNT_TOP)  return ;
+		irparams.clocks -= TIMER_COUNT_TOP;
+	}
+#endif
+
 	// Read if IR Receiver -> SPACE [xmt LED off] or a MARK [xmt LED on]
-	// digitalRead() is very slow. Optimisation is possible, but makes the code unportable
-	uint8_t  irdata = (uint8_t)digitalRead(irparams.recvpin);
+	// With IR_RECV_PIN set this is a single port read, else a digitalRead()
+	uint8_t       irdata = IR_READ_RECV();
+	uint8_t       state  = irparams.rcvstate;
+	unsigned int  timer  = irparams.timer;
 
-	irparams.timer++;  // One more 50uS tick
-	if (irparams.rawlen >= RAWBUF)  irparams.rcvstate = STATE_OVERFLOW ;  // Buffer overflow
+#if IR_ECHO_MUTE
+	if (irparams.ledon) {
+		// The detector sees our own LED; Drop the frame that was broken in to,
+		// and time the gap from when the LED goes off
+		if ((state == STATE_MARK) || (state == STATE_SPACE)) {
+			irparams.rcvstate = STATE_IDLE;
+			RECV_CONFIG_IDLE();
+		}
+		irparams.timer = 0;
+		return;
+	}
+#endif
 
-	switch(irparams.rcvstate) {
+	// One more 50uS tick, or a whole idle period
+	timer += ((state == STATE_MARK) || (state == STATE_SPACE)) ? 1 : RECV_IDLE_TICKS;
+
+	switch(state) {
 		//......................................................................
 		case STATE_IDLE: // In the middle of a gap
 			if (irdata == MARK) {
-				if (irparams.timer < GAP_TICKS)  {  // Not big enough to be a gap.
-					irparams.timer = 0;
-
-				} else {
+				if (timer >= GAP_TICKS) {
 					// Gap just ended; Record duration; Start recording transmission
-					irparams.overflow                  = false;
-					irparams.rawlen                    = 0;
-					irparams.rawbuf[irparams.rawlen++] = irparams.timer;
-					irparams.timer                     = 0;
-					irparams.rcvstate                  = STATE_MARK;
+					irparams.rawlen   = 0;
+					recordTicks(timer);
+					irparams.rcvstate = STATE_MARK;
+					RECV_CONFIG_BUSY();
+					// The MARK began somewhere in the last idle period; credit half of it
+					timer = RECV_IDLE_TICKS / 2;
+					break;
 				}
+				timer = 0;  // Not big enough to be a gap
 			}
 			break;
 		//......................................................................
 		case STATE_MARK:  // Timing Mark
 			if (irdata == SPACE) {   // Mark ended; Record time
-				irparams.rawbuf[irparams.rawlen++] = irparams.timer;
-				irparams.timer                     = 0;
-				irparams.rcvstate                  = STATE_SPACE;
+				if (recordTicks(timer))  irparams.rcvstate = STATE_SPACE ;
+				else                     RECV_CONFIG_IDLE() ;  // Slot handed over [full or streamed]
+				timer = 0;
 			}
 			break;
 		//......................................................................
 		case STATE_SPACE:  // Timing Space
 			if (irdata == MARK) {  // Space just ended; Record time
-				irparams.rawbuf[irparams.rawlen++] = irparams.timer;
-				irparams.timer                     = 0;
-				irparams.rcvstate                  = STATE_MARK;
-
-			} else if (irparams.timer > GAP_TICKS) {  // Space
-					// A long Space, indicates gap between codes
-					// Flag the current code as ready for processing
-					// Switch to STOP
-					// Don't reset timer; keep counting Space width
-					irparams.rcvstate = STATE_STOP;
+				if (recordTicks(timer))  irparams.rcvstate = STATE_MARK ;
+				else                     RECV_CONFIG_IDLE() ;  // Overflowed; slot handed over
+				timer = 0;
+
+			} else if (timer > GAP_TICKS) {  // Space
+				// A long Space, indicates gap between codes
+				// Flag the current code as ready for processing
+				// Don't reset timer; keep counting Space width
+				publishSlot(false);
+				RECV_CONFIG_IDLE();
 			}
 			break;
 		//......................................................................
-		case STATE_STOP:  // Waiting; Measuring Gap
-		 	if (irdata == MARK)  irparams.timer = 0 ;  // Reset gap timer
-		 	break;
+		case STATE_STOP:  // Waiting for a free slot; Measuring Gap
+			if (irdata == MARK) {
+				// A new frame is starting with nowhere to put it
+				if ((timer >= GAP_TICKS) && (irparams.dropped < 255))  irparams.dropped++ ;
+				timer = 0;  // Reset gap timer
+			}
+			break;
+	}
+	irparams.timer = timer;
+
+	// If requested, flash LED while receiving IR data
+	if (irparams.blinkflag) {
+		if (irdata == MARK)
+			if (irparams.blinkpin) digitalWrite(irparams.blinkpin, HIGH); // Turn user defined pin LED on
+				else BLINKLED_ON() ;   // if no user defined LED pin, turn default LED pin for the hardware on
+		else if (irparams.blinkpin) digitalWrite(irparams.blinkpin, LOW); // Turn user defined pin LED on
+				else BLINKLED_OFF() ;   // if no user defined LED pin, turn default LED pin for the hardware on
+	}
+}
+#endif // !IR_RECV_EDGE
+
+#if IR_RECV_EDGE
+//+=============================================================================
+// Edge capture ISR - Fires on every change of the receive pin
+// Works on the same state machine as the timer ISR above, but each call
+// measures a whole MARK or SPACE from the micros() timestamps of two edges.
+// Nothing fires while the room is quiet, so the SPACE that ends a frame is
+// caught either by the next MARK or by IREdgeTimeout() from decode().
+//
+void  IREdge ( )
+{
+	uint8_t  irdata = IR_READ_RECV();
+
+	// A pin-change interrupt is shared by a whole port; ignore other pins
+	if (irdata == irparams.lastlevel)  return ;
+	irparams.lastlevel = irdata;
+
+	unsigned long  now   = micros();
+	unsigned long  width = now - irparams.lastedge;
+	irparams.lastedge = now;
+
+#if IR_ECHO_MUTE
+	if (irparams.ledon) {
+		// The detector sees our own LED; Drop the frame that was broken in to
+		if ((irparams.rcvstate == STATE_MARK) || (irparams.rcvstate == STATE_SPACE))  irparams.rcvstate = STATE_IDLE ;
+		return;
+	}
+#endif
+
+	// Round to the nearest tick; clamp long gaps so the division stays 16-bit
+	unsigned int  ticks = (width > 0xFFFF - (USECPERTICK / 2))
+	                    ? (0xFFFF / USECPERTICK)
+	                    : ((unsigned int)width + (USECPERTICK / 2)) / USECPERTICK ;
+
+	switch(irparams.rcvstate) {
+		//......................................................................
+		case STATE_SPACE:  // Timing Space; this edge is the start of a MARK
+			if (ticks <= GAP_TICKS) {
+				if (recordTicks(ticks))  irparams.rcvstate = STATE_MARK ;
+				break;
+			}
+			// The frame ended before anyone called decode(); hand it over
+			//   and let this MARK start the next one
+			publishSlot(false);
+			if (irparams.rcvstate == STATE_STOP) {
+				if (irparams.dropped < 255)  irparams.dropped++ ;
+				break;
+			}
+			// fall through
+		//......................................................................
+		case STATE_IDLE: // In the middle of a gap
+			if ((irdata == MARK) && (ticks >= GAP_TICKS)) {
+				// Gap just ended; Record duration; Start recording transmission
+				irparams.rawlen   = 0;
+				recordTicks(ticks);
+				irparams.rcvstate = STATE_MARK;
+			}
+			break;
+		//......................................................................
+		case STATE_MARK:  // Timing Mark; this edge is the start of a SPACE
+			if (recordTicks(ticks))  irparams.rcvstate = STATE_SPACE ;
+			break;
 		//......................................................................
-		case STATE_OVERFLOW:  // Flag up a read overflow; Stop the State Machine
-			irparams.overflow = true;
-			irparams.rcvstate = STATE_STOP;
-		 	break;
+		case STATE_STOP:  // Waiting for a free slot
+			if ((irdata == MARK) && (ticks >= GAP_TICKS) && (irparams.dropped < 255))  irparams.dropped++ ;
+			break;
 	}
 
 	// If requested, flash LED while receiving IR data
@@ -198,3 +461,24 @@ ISR (TIMER_INTR_NAME)
 				else BLINKLED_OFF() ;   // if no user defined LED pin, turn default LED pin for the hardware on
 	}
 }
+
+//+=============================================================================
+// Finish a frame whose closing SPACE has outlasted the gap
+// The timer ISR does this itself; in edge mode decode() has to ask.
+//
+void  IREdgeTimeout ( )
+{
+	noInterrupts();
+	if ((irparams.rcvstate == STATE_SPACE) && (micros() - irparams.lastedge > _GAP))  publishSlot(false) ;
+	interrupts();
+}
+
+//+=============================================================================
+// Pin-change interrupt for a receive pin that has no external interrupt
+// Only the vector of IR_RECV_PIN's group is taken, so the others stay free for
+// other libraries [SoftwareSerial takes them all].
+//
+#if defined(IR_RECV_PCINT)
+ISR (IR_RECV_PCINT)  { IREdge(); }
+#endif
+#endif // IR_RECV_EDGE
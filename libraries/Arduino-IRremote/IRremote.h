@@ -28,56 +28,142 @@
 // Each protocol you include costs memory and, during decode, costs time
 // Disable (set to 0) all the protocols you do not need/want!
 //
-#define DECODE_RC5           1
-#define SEND_RC5             1
+// Every setting below can be chosen for a build without editing this file, by
+// passing it to the compiler [e.g. in build_flags, or compiler.cpp.extra_flags]:
+//   -DIR_DECODE_ALL=0 -DDECODE_NEC=1  : Only the NEC decoder [and decodeHash]
+//   -DIR_SEND_ALL=0                   : No senders; For sketches that only receive
+// They must be the same for the sketch and the library, so don't #define them in
+// the sketch : The library is compiled on its own and would not see them.
+//
+#ifndef IR_DECODE_ALL
+#define IR_DECODE_ALL        1  // Default for every DECODE_ below
+#endif
+#ifndef IR_SEND_ALL
+#define IR_SEND_ALL          1  // Default for every SEND_ below
+#endif
 
-#define DECODE_RC6           1
-#define SEND_RC6             1
+#ifndef DECODE_RC5
+#define DECODE_RC5           IR_DECODE_ALL
+#endif
+#ifndef SEND_RC5
+#define SEND_RC5             IR_SEND_ALL
+#endif
 
-#define DECODE_NEC           1
-#define SEND_NEC             1
+#ifndef DECODE_RC6
+#define DECODE_RC6           IR_DECODE_ALL
+#endif
+#ifndef SEND_RC6
+#define SEND_RC6             IR_SEND_ALL
+#endif
 
-#define DECODE_SONY          1
-#define SEND_SONY            1
+#ifndef DECODE_NEC
+#define DECODE_NEC           IR_DECODE_ALL
+#endif
+#ifndef SEND_NEC
+#define SEND_NEC             IR_SEND_ALL
+#endif
 
-#define DECODE_PANASONIC     1
-#define SEND_PANASONIC       1
+#ifndef DECODE_SONY
+#define DECODE_SONY          IR_DECODE_ALL
+#endif
+#ifndef SEND_SONY
+#define SEND_SONY            IR_SEND_ALL
+#endif
 
-#define DECODE_JVC           1
-#define SEND_JVC             1
+#ifndef DECODE_PANASONIC
+#define DECODE_PANASONIC     IR_DECODE_ALL
+#endif
+#ifndef SEND_PANASONIC
+#define SEND_PANASONIC       IR_SEND_ALL
+#endif
+
+#ifndef DECODE_JVC
+#define DECODE_JVC           IR_DECODE_ALL
+#endif
+#ifndef SEND_JVC
+#define SEND_JVC             IR_SEND_ALL
+#endif
 
-#define DECODE_SAMSUNG       1
-#define SEND_SAMSUNG         1
+#ifndef DECODE_SAMSUNG
+#define DECODE_SAMSUNG       IR_DECODE_ALL
+#endif
+#ifndef SEND_SAMSUNG
+#define SEND_SAMSUNG         IR_SEND_ALL
+#endif
 
-#define DECODE_WHYNTER       1
-#define SEND_WHYNTER         1
+#ifndef DECODE_WHYNTER
+#define DECODE_WHYNTER       IR_DECODE_ALL
+#endif
+#ifndef SEND_WHYNTER
+#define SEND_WHYNTER         IR_SEND_ALL
+#endif
 
-#define DECODE_AIWA_RC_T501  1
-#define SEND_AIWA_RC_T501    1
+#ifndef DECODE_AIWA_RC_T501
+#define DECODE_AIWA_RC_T501  IR_DECODE_ALL
+#endif
+#ifndef SEND_AIWA_RC_T501
+#define SEND_AIWA_RC_T501    IR_SEND_ALL
+#endif
 
-#define DECODE_LG            1
-#define SEND_LG              1
+#ifndef DECODE_LG
+#define DECODE_LG            IR_DECODE_ALL
+#endif
+#ifndef SEND_LG
+#define SEND_LG              IR_SEND_ALL
+#endif
 
-#define DECODE_SANYO         1
+#ifndef DECODE_SANYO
+#define DECODE_SANYO         IR_DECODE_ALL
+#endif
+#ifndef SEND_SANYO
 #define SEND_SANYO           0 // NOT WRITTEN
+#endif
 
-#define DECODE_MITSUBISHI    1
+#ifndef DECODE_MITSUBISHI
+#define DECODE_MITSUBISHI    IR_DECODE_ALL
+#endif
+#ifndef SEND_MITSUBISHI
 #define SEND_MITSUBISHI      0 // NOT WRITTEN
+#endif
 
+#ifndef DECODE_DISH
 #define DECODE_DISH          0 // NOT WRITTEN
-#define SEND_DISH            1
+#endif
+#ifndef SEND_DISH
+#define SEND_DISH            IR_SEND_ALL
+#endif
 
+#ifndef DECODE_SHARP
 #define DECODE_SHARP         0 // NOT WRITTEN
-#define SEND_SHARP           1
+#endif
+#ifndef SEND_SHARP
+#define SEND_SHARP           IR_SEND_ALL
+#endif
 
-#define DECODE_DENON         1
-#define SEND_DENON           1
+#ifndef DECODE_DENON
+#define DECODE_DENON         IR_DECODE_ALL
+#endif
+#ifndef SEND_DENON
+#define SEND_DENON           IR_SEND_ALL
+#endif
 
+#ifndef DECODE_PRONTO
 #define DECODE_PRONTO        0 // This function doe not logically make sense
-#define SEND_PRONTO          1
+#endif
+#ifndef SEND_PRONTO
+#define SEND_PRONTO          IR_SEND_ALL
+#endif
+
+#ifndef SEND_RAW_PACKED
+#define SEND_RAW_PACKED      IR_SEND_ALL  // Raw codes packed in to PROGMEM [see irRawPacked.cpp]
+#endif
 
+#ifndef DECODE_LEGO_PF
 #define DECODE_LEGO_PF       0 // NOT WRITTEN
-#define SEND_LEGO_PF         1
+#endif
+#ifndef SEND_LEGO_PF
+#define SEND_LEGO_PF         IR_SEND_ALL
+#endif
 
 //------------------------------------------------------------------------------
 // When sending a Pronto code we request to send either the "once" code
@@ -94,6 +180,13 @@
 #define PRONTO_FALLBACK    true
 #define PRONTO_NOFALLBACK  false
 
+//------------------------------------------------------------------------------
+// Where a frame given to IRsend::sendRawAsync() has got to [sendStatus()]
+//
+#define IR_SEND_QUEUED   0
+#define IR_SEND_SENDING  1
+#define IR_SEND_DONE     2
+
 //------------------------------------------------------------------------------
 // An enumerated list of all supported formats
 // You do NOT need to remove entries from this list when disabling protocols!
@@ -140,13 +233,75 @@ decode_type_t;
 
 //------------------------------------------------------------------------------
 // Mark & Space matching functions
+// Out of line with DEBUG so they can report, otherwise inline and integer only
 //
+#if DEBUG
 int  MATCH       (int measured, int desired) ;
 int  MATCH_MARK  (int measured_ticks, int desired_us) ;
 int  MATCH_SPACE (int measured_ticks, int desired_us) ;
+#else
+static inline int  MATCH (int measured,  int desired)
+{
+	return (measured >= TICKS_LOW(desired)) && (measured <= TICKS_HIGH(desired));
+}
+
+static inline int  MATCH_MARK (int measured_ticks,  int desired_us)
+{
+	return MATCH(measured_ticks, desired_us + MARK_EXCESS);
+}
+
+static inline int  MATCH_SPACE (int measured_ticks,  int desired_us)
+{
+	return MATCH(measured_ticks, desired_us - MARK_EXCESS);
+}
+#endif
+
+// Match against a precomputed MARK_TICKS() / SPACE_TICKS() window
+static inline bool  MATCH_TICKS (unsigned int measured_ticks,  irticks_t window)
+{
+	return (measured_ticks >= window.lo) && (measured_ticks <= window.hi);
+}
+
+#if IR_RESULT_BITS
+//------------------------------------------------------------------------------
+// Every bit of a decoded frame, in the order received [the first is the top
+// bit of byte[0]], however long the frame; Bits past IR_RESULT_BITS are
+// counted, but not kept.  The decoders append each bit as they read it.
+// equals() and hash() are for matching learned buttons.
+//
+class irbits_t
+{
+	public:
+		uint8_t  count;                            // Bits in the frame
+		uint8_t  byte[(IR_RESULT_BITS + 7) / 8];
+
+		void  clear ( )  { count = 0; }
+
+		void  append (bool one)
+		{
+			if (count < IR_RESULT_BITS) {
+				uint8_t  mask = 0x80 >> (count & 7);
+
+				if (one)  byte[count >> 3] |=  mask ;
+				else      byte[count >> 3] &= ~mask ;
+			}
+			if (count < 255)  count++ ;
+		}
+
+		// Bit i [0 = The first received]; Only the first IR_RESULT_BITS are kept
+		bool  get (uint8_t i) const  { return (byte[i >> 3] >> (7 - (i & 7))) & 1; }
+
+		void           append (unsigned long value,  uint8_t nbits) ;  // Its low nbits, top first
+		bool           equals (const irbits_t *other) const ;
+		unsigned long  hash   ( ) const ;
+};
+#endif
 
 //------------------------------------------------------------------------------
 // Results returned from the decoder
+// rawbuf, rawlen and tick are the frame being decoded : A read-only view of
+// the capture slot [or of any other durations, see IRrecv::decodeSpan()]; The
+// decoders only read it through rawAt(), and never touch irparams.
 //
 class decode_results
 {
@@ -155,9 +310,151 @@ class decode_results
 		unsigned int           address;      // Used by Panasonic & Sharp [16-bits]
 		unsigned long          value;        // Decoded value [max 32-bits]
 		int                    bits;         // Number of bits in decoded value
-		volatile unsigned int  *rawbuf;      // Raw intervals in 50uS ticks
+#if IR_RESULT_BITS
+		irbits_t               data;         // Every bit [of a frame of any length]; Empty for a REPEAT
+#endif
+		const irraw_t          *rawbuf;      // Raw intervals, gap first; read via rawAt()
+#if IR_COMPACT_RAWBUF
+		const unsigned int     *rawlong;     // Escaped long intervals of the same frame
+#endif
 		int                    rawlen;       // Number of records in rawbuf
+		uint8_t                tick;         // uS per count in rawbuf [USECPERTICK from the receiver]
 		int                    overflow;     // true iff IR raw code too long
+		unsigned long          stamp;        // millis() as the frame began [taken by the ISR]
+
+		decode_results ( ) : tick(USECPERTICK) { }
+
+		// Interval i in 50uS ticks, whatever the rawbuf encoding
+		unsigned int  rawAt (int i) const
+		{
+#if IR_COMPACT_RAWBUF
+			uint8_t       b = rawbuf[i];
+			unsigned int  t = (b < IR_RAW_ESCAPE) ? b : rawlong[b - IR_RAW_ESCAPE];
+#else
+			unsigned int  t = rawbuf[i];
+#endif
+			if (tick != USECPERTICK)  t = ((unsigned long)t * tick + USECPERTICK / 2) / USECPERTICK ;
+			return t;
+		}
+};
+
+//------------------------------------------------------------------------------
+// Header signature of a protocol : What its first MARK and SPACE can look like
+// decode() only runs the decoders whose signature fits rawbuf[1] and rawbuf[2]
+// Each ir_*.cpp with a decoder defines one, in PROGMEM
+//
+typedef
+	struct {
+		int8_t        type;       // decode_type_t of the decoder
+		irticks_t     mark;       // First MARK after the gap
+		irticks_t     space;      // First SPACE
+		const irpulse_t  *pulse;  // Its irpulse_t, if decoded from rawbuf[1] by that alone; else NULL
+	}
+irsig_t;
+
+//------------------------------------------------------------------------------
+// Fingerprint of a frame [see IRrecv::fingerprint()]
+// Compare two with IRrecv::fingerprintDistance()
+//
+#define IR_FP_BUCKETS    64          // 8 octaves of 8 log-scale buckets
+#define IR_FP_LEVELS      8          // Lengths told apart, of MARK and of SPACE
+#define IR_FP_DURATIONS  (RAWBUF - 1)
+
+typedef
+	struct {
+		unsigned long  hash;                                // Same as decodeHash()
+		uint8_t        len;                                 // Durations after the gap
+		uint8_t        levels[2];                           // Number of MARK, SPACE lengths
+		uint8_t        start[2][IR_FP_LEVELS];              // Bucket each length starts at
+		uint8_t        level[(IR_FP_DURATIONS + 1) / 2];    // Of each MARK [low 4 bits] and SPACE
+	}
+irfingerprint_t;
+
+extern const irsig_t  necSignature, sonySignature, sanyoSignature, mitsubishiSignature,
+                      rc5Signature, rc6Signature, panasonicSignature, lgSignature,
+                      jvcSignature, samsungSignature, whynterSignature, aiwaSignature,
+                      denonSignature;
+
+//------------------------------------------------------------------------------
+// A frame to send, one MARK or SPACE at a time
+// next() gives each duration in turn [uS; MARK first, then SPACE, MARK ...] and
+// false after the last [and on every call after that].  IRsend::send() runs it
+// through mark() and space(); IRsend::sendAsync() hands it to the timer
+// interrupt, which asks for each duration as the one before it ends, so the
+// frame is never laid out in RAM.  There next() runs in the ISR : Keep it quick.
+//
+class IRencoder
+{
+	public:
+		uint8_t  khz;  // Carrier
+
+		virtual bool  next (unsigned long *usec) = 0;
+		virtual void  sent ( ) { }  // Run by the ISR once a queued frame is out
+};
+
+//------------------------------------------------------------------------------
+// Description of a protocol to send : A header, bits of two halves, a stop
+// Pulse distance : A 1 is MARK(one[0]) + SPACE(one[1]); A 0 is MARK(zero[0]) + SPACE(zero[1])
+// Pulse width    : The same, with the MARKs differing instead
+// Manchester     : Halves of T, a 1 or a 0 starting with a SPACE [IR_ENC_*_SPACE]
+// Halves at the same level run together, and a SPACE before the first MARK is
+// dropped [it would be lost in the gap].  Timings are in uS.
+// Kept in PROGMEM and run by IRbitEncoder
+//
+typedef
+	struct {
+		unsigned int   hdr[4];    // Header MARK, SPACE [, MARK, SPACE]; 0 = None
+		unsigned int   rpt;       // A repeat is hdr[0] + SPACE(rpt) + stop; 0 = The frame again
+		unsigned int   one[2];    // Halves of a 1
+		unsigned int   zero[2];   // Halves of a 0
+		unsigned int   stop[2];   // MARK, SPACE after the last bit; 0 = None
+		unsigned int   toggle;    // XOR'd in to the data from one frame to the next
+		unsigned long  period;    // Frames start this far apart; 0 = _GAP between them
+		uint8_t        khz;       // Carrier
+		uint8_t        start;     // Bits of 1 sent ahead of the address and data
+		uint8_t        wide;      // Bit whose halves are doubled, counting from the first start bit as 0; 0 = None
+		uint8_t        flags;     // IR_ENC_* below
+	}
+irencoding_t;
+
+#define IR_ENC_ONE_SPACE   0x01  // A 1 is SPACE(one[0]) + MARK(one[1])
+#define IR_ENC_ZERO_SPACE  0x02  // A 0 is SPACE(zero[0]) + MARK(zero[1])
+#define IR_ENC_RPT_NOHDR   0x04  // A repeat is the frame without its header [JVC]
+
+// Each ir_*.cpp with a sender defines one, in PROGMEM
+extern const irencoding_t  necEncoding, sonyEncoding, rc5Encoding, rc6Encoding,
+                           panasonicEncoding, jvcEncoding, samsungEncoding,
+                           whynterEncoding, aiwaEncoding, lgEncoding, dishEncoding,
+                           sharpEncoding, denonEncoding;
+
+//------------------------------------------------------------------------------
+// Frames of any protocol described by an irencoding_t [see irEncoder.cpp]
+// 'frames' of them : The first whole, the rest as repeats; 0 sends one repeat.
+// Bits go most significant first : The address [if any], then the data.
+//
+class IRbitEncoder : public IRencoder
+{
+	public:
+		void  begin (const irencoding_t *enc_P,  unsigned long data,  uint8_t nbits,  uint8_t frames = 1) ;
+		void  begin (const irencoding_t *enc_P,  unsigned long address,  uint8_t abits,
+		             unsigned long data,  uint8_t nbits,  uint8_t frames = 1) ;
+		bool  next  (unsigned long *usec) ;
+
+	private:
+		const irencoding_t  *enc;  // PROGMEM
+		unsigned long  address;
+		unsigned long  data;
+		unsigned long  held;       // Read ahead of the last duration; Starts the next
+		unsigned long  elapsed;    // Of this frame so far
+		uint8_t        abits;
+		uint8_t        nbits;
+		uint8_t        frames;     // Still to send, this one included
+		uint8_t        step;       // Part of the frame next
+		uint8_t        half;       // Next half of the bits, counting from the first start bit
+		uint8_t        level;      // Of the next duration
+		bool           repeat;     // This frame is a repeat
+
+		bool  piece (uint8_t *lvl,  unsigned long *usec) ;
 };
 
 //------------------------------------------------------------------------------
@@ -175,19 +472,76 @@ class IRrecv
 		IRrecv (int recvpin, int blinkpin);
 
 		void  blink13    (int blinkflag) ;
+		bool  capture    (decode_results *results) ;
 		int   decode     (decode_results *results) ;
+		bool  decodeSpan (decode_results *results,  const irraw_t *buf,  int len,  uint8_t tick = USECPERTICK) ;  // Durations from anywhere
 		void  enableIRIn ( ) ;
 		bool  isIdle     ( ) ;
 		void  resume     ( ) ;
+		unsigned int  dropped ( ) ;
+#		if IR_DECODE_CACHE
+			// Frames decode() answered from the last one, and ones it decoded
+			unsigned int  cacheHits   ( ) ;
+			unsigned int  cacheMisses ( ) ;
+#		endif
+
+#		if IR_SEND_ASYNC
+			// Send every frame captured from now on straight back out, from the ISR
+			// and as it was received, at khz [0 stops]; capture() sees none of them.
+			// excess -> Take MARK_EXCESS off the MARKs and add it to the SPACEs
+			void  relay (uint8_t khz,  bool excess = true) ;
+#		endif
+
+		// Only try this protocol from now on [UNKNOWN to try them all again]
+		// With IR_RECV_STREAM the ISR also decodes it, if it can be streamed
+		void  lockProtocol (decode_type_t type) ;
+
+		// Tolerant hash and signature of any frame [value is set to the hash]
+		bool            fingerprint         (decode_results *results,  irfingerprint_t *fp) ;
+		static uint8_t  fingerprintDistance (const irfingerprint_t *a,  const irfingerprint_t *b,  uint8_t limit) ;
 
 	private:
+		int8_t  recent;  // Protocol that decoded last; Tried first
+		int8_t  locked;  // Only protocol tried, or UNKNOWN
+
+#		if IR_DECODE_CACHE
+			// The last frame decode() decoded, and what it decoded to
+			uint8_t        cacheLen;              // Its rawlen; 0 -> nothing cached
+			uint8_t        cacheRaw[RAWBUF - 1];  // Its durations after the gap [ticks, up to 255]
+			int8_t         cacheType;
+			unsigned int   cacheAddress;
+			unsigned long  cacheValue;
+			int            cacheBits;
+#			if IR_RESULT_BITS
+				irbits_t       cacheData;
+#			endif
+			unsigned int   hits;
+			unsigned int   misses;
+
+			bool  decodeCached (decode_results *results) ;
+			void  cacheResult  (decode_results *results) ;
+#		endif
+
+		bool  decodeProtocol (int8_t type,  decode_results *results) ;
+		bool  decodeMatching (decode_results *results,  int8_t only,  int8_t skip) ;
+		bool  decodeFrame    (decode_results *results) ;
+#		if IR_GLITCH_TICKS
+			void  filterGlitches (decode_results *results) ;
+#		endif
+
 		long  decodeHash (decode_results *results) ;
-		int   compare    (unsigned int oldval, unsigned int newval) ;
+
+		// Shared by every protocol described by an irpulse_t
+		bool  decodePulseDistance (decode_results *results,  const irpulse_t *proto_P,  int offset) ;
+#		if IR_RECV_STREAM
+			// A frame the ISR decoded as it arrived
+			bool  decodeStreamed (decode_results *results,  volatile irslot_t *slot) ;
+#		endif
 
 		//......................................................................
 #		if (DECODE_RC5 || DECODE_RC6)
-			// This helper function is shared by RC5 and RC6
-			int  getRClevel (decode_results *results,  int *offset,  int *used,  int t1) ;
+			// Shared by RC5 and RC6
+			bool  decodeManchester (decode_results *results,  const irmanchester_t *proto_P,  int offset) ;
 #		endif
 #		if DECODE_RC5
 			bool  decodeRC5        (decode_results *results) ;
@@ -266,6 +620,21 @@ class IRsend
 		void  mark        		(unsigned int usec) ;
 		void  space       		(unsigned int usec) ;
 		void  sendRaw     		(const unsigned int buf[],  unsigned int len,  unsigned int hz) ;
+		void  send        		(IRencoder *enc) ;  // Every duration it gives
+#		if SEND_RAW_PACKED
+			void  sendRawPacked_P (const uint8_t *code_P) ;  // Packed in to PROGMEM [see irRawPacked.cpp]
+#		endif
+
+#		if IR_SEND_ASYNC
+			// Queue a frame and return at once; The timer interrupt sends it.
+			// buf must be left alone until sendStatus() gives IR_SEND_DONE.
+			// Returns the frame's ticket, or -1 if the queue is full.
+			int      sendRawAsync   (const unsigned int buf[],  uint8_t len,  uint8_t khz) ;
+			int      sendRawAsync_P (const unsigned int *buf_P,  uint8_t len,  uint8_t khz) ;
+			int      sendAsync      (IRencoder *enc) ;  // Left alone until done, as buf
+			uint8_t  sendStatus     (uint8_t ticket) ;  // IR_SEND_QUEUED, _SENDING or _DONE
+			bool     sendBusy       ( ) ;               // true -> Frames still to send
+#		endif
 
 		//......................................................................
 #		if SEND_RC5
@@ -333,7 +702,11 @@ class IRsend
 #		endif
 		//......................................................................
 #		if SEND_PRONTO
-			void  sendPronto     (char* code,  bool repeat,  bool fallback) ;
+			bool  sendPronto     (char* code,  bool repeat,  bool fallback) ;
+			void  sendPronto_P   (const unsigned int *code_P,  bool repeat,  bool fallback) ;  // Compiled [see irPronto.cpp]
+#			if IR_SEND_ASYNC
+				int  sendProntoAsync_P (const unsigned int *code_P,  bool repeat,  bool fallback) ;
+#			endif
 #		endif
 //......................................................................
 #		if SEND_LEGO_PF
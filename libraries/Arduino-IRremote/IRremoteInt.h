@@ -42,6 +42,133 @@
 //
 #define RAWBUF  101  // Maximum length of raw duration buffer
 
+// Number of completed frames the ISR can hold while decode() catches up.
+// Must be a power of two.  1 gives the original single-buffer behaviour: A
+// frame that ends while the last one is still held is lost.
+// Each slot is about 210 bytes of SRAM [125 with IR_COMPACT_RAWBUF], so a
+// second one is opt-in on a 2KB board.  It pays off when the sketch can go a
+// whole frame or more without calling decode() [see test/burst.cpp].
+#ifndef IR_CAPTURE_SLOTS
+#define IR_CAPTURE_SLOTS  1
+#endif
+
+#if (IR_CAPTURE_SLOTS < 1) || (IR_CAPTURE_SLOTS & (IR_CAPTURE_SLOTS - 1))
+#	error "IR_CAPTURE_SLOTS must be a power of two"
+#endif
+
+// Set to 1 to timestamp edges on the receive pin (external or pin-change
+// interrupt + micros()) instead of sampling it from the timer every USECPERTICK.
+// The same rawbuf format is produced, so all the decoders work unchanged.
+// It needs IR_RECV_PIN, which picks D2 or D3's external interrupt or another
+// pin's pin-change vector [see boarddefs.h]; Without one it does not build.
+#ifndef IR_RECV_EDGE
+#define IR_RECV_EDGE  0
+#endif
+
+// Set to 1 to let the timer ISR run at a coarser rate between frames (on
+// timers that support it, see TIMER_IDLE_TICKS) and at the full USECPERTICK
+// rate only from the first MARK until the closing gap.  The first MARK is then
+// only timed to within an idle period, so it is off by default.
+#ifndef IR_ADAPTIVE_RATE
+#define IR_ADAPTIVE_RATE  0
+#endif
+
+// Set to 1 to let the ISR decode the protocol given to IRrecv::lockProtocol()
+// as its edges arrive.  The frame is handed to decode() as soon as its last
+// MARK ends, instead of after GAP_TICKS of silence, and decode() has no bits
+// left to read.  Only protocols with a header and a fixed bit count, that do
+// not need the gap to check the length, can be streamed (see lockProtocol()).
+#ifndef IR_RECV_STREAM
+#define IR_RECV_STREAM  0
+#endif
+
+// MARKs and SPACEs this short [in ticks] are glitches: ambient IR, or the
+// receiver ringing.  capture() merges each one, and the durations either side
+// of it, into one before anything decodes the frame.  0 turns the filter off.
+#ifndef IR_GLITCH_TICKS
+#define IR_GLITCH_TICKS  2
+#endif
+
+// Set to 1 to let decode() keep the last frame a protocol decoder decoded
+// [about RAWBUF + 10 bytes per IRrecv], and answer a frame that is the same to
+// within 1/8, duration by duration, from it without decoding again: A held
+// button, or a remote that sends each frame several times, gives the same
+// frame over and over.
+#ifndef IR_DECODE_CACHE
+#define IR_DECODE_CACHE  0
+#endif
+
+// Most bits decode_results::data keeps of a frame, for protocols longer than
+// the 32 bits of value [Panasonic, RC6 MCE ...]; 0 leaves it out.
+#ifndef IR_RESULT_BITS
+#define IR_RESULT_BITS  64
+#endif
+
+#if IR_RESULT_BITS
+#	define IR_RESULT_APPEND(results, one)  (results)->data.append(one)
+#else
+#	define IR_RESULT_APPEND(results, one)
+#endif
+
+// Set to 1 to share the timer between IRsend and IRrecv.  Sending takes the
+// timer for the carrier; Once it is done, capture() [or the IR_SEND_ASYNC ISR]
+// gives it back to the receiver, with no need to call enableIRIn() again.
+// Where the board has TIMER_CARRIER_CLOCKS the receiver goes on sampling, off
+// the carrier interrupt, while the frame is sent.
+#ifndef IR_FULL_DUPLEX
+#define IR_FULL_DUPLEX  1
+#endif
+
+// The receiver only needs the timer when it is sampling the pin
+#define IR_RECV_SHARED  (IR_FULL_DUPLEX && !IR_RECV_EDGE)
+
+// Set to 1 if the IR detector can see the IR LED.  While the LED is on, all
+// the detector sees is our own frame, so the receiver drops whatever it was
+// capturing and only starts a new frame after a whole gap with the LED off.
+#ifndef IR_ECHO_MUTE
+#define IR_ECHO_MUTE  1
+#endif
+
+// Map a free-running slot counter on to an index in irparams.slot[]
+#define IR_SLOT(n)  ((uint8_t)(n) & (IR_CAPTURE_SLOTS - 1))
+
+// Set to 1 to store each duration in one byte instead of two.
+// Almost every mark and space is under 248 ticks (12.4mS); the few that are not
+// (the leading gap, long A/C headers) are kept in a small per-slot table and the
+// byte holds IR_RAW_ESCAPE + their index there.
+// This halves the rawbuf footprint, or lets RAWBUF be doubled for the same RAM.
+// Always read durations through decode_results::rawAt().
+#ifndef IR_COMPACT_RAWBUF
+#define IR_COMPACT_RAWBUF  0
+#endif
+
+#if IR_COMPACT_RAWBUF
+#	define IR_RAW_LONGS   8                      // Long durations per slot
+#	define IR_RAW_ESCAPE  (256 - IR_RAW_LONGS)   // First escape byte value
+	typedef  uint8_t       irraw_t;
+#else
+	typedef  unsigned int  irraw_t;
+#endif
+
+typedef
+	struct {
+		uint8_t       rawlen;          // Number of records in rawbuf
+		uint8_t       overflow;        // Raw buffer overflow occurred
+		unsigned long stamp;           // millis() as the first MARK began
+#if IR_COMPACT_RAWBUF
+		uint8_t       rawlongs;        // Number of entries used in rawlong
+		unsigned int  rawlong[IR_RAW_LONGS];  // Durations too long for one byte
+#endif
+#if IR_RECV_STREAM
+		uint8_t       streamed;        // true -> the ISR decoded it; the values below are valid
+		const void   *streamproto;     // irpulse_t it was decoded as [irstream.proto then]
+		unsigned int  streamhigh;      // Bits before the last 32 [see decodePulseDistance()]
+		unsigned long streamdata;      // Last 32 bits, in the order they arrived
+#endif
+		irraw_t       rawbuf[RAWBUF];  // raw data
+	}
+irslot_t;
+
 typedef
 	struct {
 		// The fields are ordered to reduce memory over caused by struct-padding
@@ -49,10 +176,24 @@ typedef
 		uint8_t       recvpin;         // Pin connected to IR data from detector
 		uint8_t       blinkpin;
 		uint8_t       blinkflag;       // true -> enable blinking of pin on IR processing
-		uint8_t       rawlen;          // counter of entries in rawbuf
+		uint8_t       rawlen;          // counter of entries in the slot being captured
+		uint8_t       head;            // Slots completed by the ISR      [only the ISR writes this]
+		uint8_t       tail;            // Slots released by resume()      [only resume() writes this; the sender's ISR, relaying]
+		uint8_t       dropped;         // Frames lost because every slot was full
 		unsigned int  timer;           // State timer, counts 50uS ticks.
-		unsigned int  rawbuf[RAWBUF];  // raw data
-		uint8_t       overflow;        // Raw buffer overflow occurred
+#if IR_RECV_EDGE
+		uint8_t       lastlevel;       // Pin level after the last edge
+		unsigned long lastedge;        // micros() at the last edge
+#endif
+#if IR_RECV_SHARED
+		uint8_t       armed;           // true -> enableIRIn() has run; IRsend must give the timer back
+		uint8_t       lent;            // true -> IRsend has the timer [carrier]
+		unsigned int  clocks;          // Timer clocks towards the next tick, while lent
+#endif
+#if IR_ECHO_MUTE
+		uint8_t       ledon;           // true -> The IR LED is on [IRsend::mark()]
+#endif
+		irslot_t      slot[IR_CAPTURE_SLOTS];  // Ring of captured frames
 	}
 irparams_t;
 
@@ -60,7 +201,7 @@ irparams_t;
 #define STATE_IDLE      2
 #define STATE_MARK      3
 #define STATE_SPACE     4
-#define STATE_STOP      5
+#define STATE_STOP      5  // Every slot is full; waiting for resume()
 #define STATE_OVERFLOW  6
 
 // Allow all parts of the code access to the ISR data
@@ -68,6 +209,25 @@ irparams_t;
 // Therefore we declare it as "volatile" to stop the compiler/CPU caching it
 EXTERN  volatile irparams_t  irparams;
 
+// IRsend tells the receiver when the LED goes on and off [IR_ECHO_MUTE]
+#if IR_ECHO_MUTE
+#	define IR_ECHO_LED(on)  (irparams.ledon = (on))
+#else
+#	define IR_ECHO_LED(on)
+#endif
+
+#if IR_RECV_SHARED
+// Give the timer back to the receiver once IRsend is done with it
+void  IRrecvReclaim ( ) ;
+#endif
+
+#if IR_RECV_EDGE
+// Edge capture ISR, and the end-of-frame check that decode() runs because
+// there is no timer tick to notice a long SPACE (see IRremote.cpp)
+void  IREdge        ( ) ;
+void  IREdgeTimeout ( ) ;
+#endif
+
 //------------------------------------------------------------------------------
 // Defines for setting and clearing register bits
 //
@@ -91,15 +251,97 @@ EXTERN  volatile irparams_t  irparams;
 
 // Upper and Lower percentage tolerances in measurements
 #define TOLERANCE       25
-#define LTOL            (1.0 - (TOLERANCE/100.))
-#define UTOL            (1.0 + (TOLERANCE/100.))
 
 // Minimum gap between IR transmissions
 #define _GAP            5000
 #define GAP_TICKS       (_GAP/USECPERTICK)
 
-#define TICKS_LOW(us)   ((int)(((us)*LTOL/USECPERTICK)))
-#define TICKS_HIGH(us)  ((int)(((us)*UTOL/USECPERTICK + 1)))
+// Integer only, so constant arguments fold at compile time.  The same windows
+// as the floating-point us * 0.75 / USECPERTICK and us * 1.25 / USECPERTICK + 1,
+// cast to int, gave [the + 1 is inside the division, so that a window below
+// 0uS rounds as it did; see test/ticks.cpp]
+#define TICKS_LOW(us)   ((int)(((long)(us) * (100 - TOLERANCE)) / (100L * USECPERTICK)))
+#define TICKS_HIGH(us)  ((int)(((long)(us) * (100 + TOLERANCE) + 100L * USECPERTICK) / (100L * USECPERTICK)))
+
+// Tick window accepted for a MARK or SPACE of 'us', for use in const tables
+#define MARK_TICKS(us)   { TICKS_LOW((us) + MARK_EXCESS), TICKS_HIGH((us) + MARK_EXCESS) }
+#define SPACE_TICKS(us)  { TICKS_LOW((us) - MARK_EXCESS), TICKS_HIGH((us) - MARK_EXCESS) }
+#define NO_TICKS         { 0, 0 }
+#define ANY_TICKS        { 0, 0xFFFF }
+
+// Tick window spanning two durations [eg. a header and a repeat space]
+#define MARK_RANGE(lo, hi)   { TICKS_LOW((lo) + MARK_EXCESS), TICKS_HIGH((hi) + MARK_EXCESS) }
+#define SPACE_RANGE(lo, hi)  { TICKS_LOW((lo) - MARK_EXCESS), TICKS_HIGH((hi) - MARK_EXCESS) }
+
+typedef
+	struct {
+		unsigned int  lo;  // Shortest accepted duration in ticks
+		unsigned int  hi;  // Longest accepted duration in ticks [0 = Not used]
+	}
+irticks_t;
+
+//------------------------------------------------------------------------------
+// Description of a pulse distance (or pulse width) protocol
+// Every bit is a fixed half and a varying half whose length gives the bit value.
+// Pulse distance: MARK(bitFixed) + SPACE(bitOne|bitZero)
+// Pulse width   : SPACE(bitFixed) + MARK(bitOne|bitZero)  [IR_PD_PULSE_WIDTH]
+// Timings are tick windows, built with MARK_TICKS() and SPACE_TICKS()
+// Kept in PROGMEM and run by IRrecv::decodePulseDistance()
+//
+typedef
+	struct {
+		irticks_t     hdrMark;    // NO_TICKS = No header
+		irticks_t     hdrSpace;   // NO_TICKS = No header space
+		irticks_t     rptSpace;   // hdrMark + rptSpace + bitFixed is a REPEAT; NO_TICKS = None
+		irticks_t     bitFixed;   // Fixed half of every bit
+		irticks_t     bitOne;     // Varying half of a 1
+		irticks_t     bitZero;    // Varying half of a 0
+		uint8_t       bits;       // Bits per frame [The minimum with IR_PD_PULSE_WIDTH]
+		uint8_t       flags;      // IR_PD_* below
+		int8_t        type;       // decode_type_t reported on success
+	}
+irpulse_t;
+
+#define IR_PD_STOP         0x01  // A bitFixed MARK must follow the last bit
+#define IR_PD_EXACT        0x02  // rawlen must be exactly the frame length
+#define IR_PD_RPT_NOHDR    0x04  // The bits without the header is a REPEAT [JVC]
+#define IR_PD_PULSE_WIDTH  0x08  // Data is in the MARKs; Bits are read until the frame ends
+#define IR_PD_LSB_FIRST    0x10  // First bit received is the least significant
+
+//------------------------------------------------------------------------------
+// Description of a Manchester [bi-phase] protocol : RC5, RC6
+// Every bit is two halves of T, at opposite levels.  Halves at the same level
+// run together, so each MARK or SPACE is 1, 2 or 3 halves long.
+// Kept in PROGMEM and run by IRrecv::decodeManchester()
+//
+typedef
+	struct {
+		irticks_t     mark[3];    // MARK of 1, 2 and 3 halves, built with MARK_TICKS()
+		irticks_t     space[3];   // SPACE of 1, 2 and 3 halves
+		uint8_t       one;        // Level of the first half of a 1
+		uint8_t       start;      // Start bits [all 1] before the data; Not reported
+		uint8_t       wide;       // Bit whose halves are 2T, counting from the first start bit as 0; 0 = None
+		int8_t        type;       // decode_type_t reported on success
+	}
+irmanchester_t;
+
+#if IR_RECV_STREAM
+//------------------------------------------------------------------------------
+// State of the decoder the ISR runs for the locked protocol
+// Set up by IRrecv::lockProtocol(), worked on by the ISR one duration at a time
+//
+typedef
+	struct {
+		const irpulse_t  *proto;       // PROGMEM description; NULL = Not streaming
+		uint8_t       framelen;        // rawlen of a whole frame [gap + header + bits + last MARK]
+		uint8_t       end;             // rawlen that completes the current frame; 0 = Gave up on it
+		unsigned int  high;            // Bits shifted out of the top of data
+		unsigned long data;            // Bits so far
+	}
+irstream_t;
+
+EXTERN  volatile irstream_t  irstream;
+#endif
 
 //------------------------------------------------------------------------------
 // IR detector output is active low
@@ -110,4 +352,67 @@ EXTERN  volatile irparams_t  irparams;
 // All board specific stuff has been moved to its own file, included here.
 #include "boarddefs.h"
 
+//------------------------------------------------------------------------------
+// Set to 1 for IRsend::sendRawAsync() : A queue of frames that the timer
+// interrupt sends while loop() carries on.  Sending, the timer runs at the
+// carrier frequency and its compare interrupt counts carrier periods, so this
+// needs the timer whose compare interrupt is once per period : Timer2.
+// IRrecv::relay() needs it too.
+//
+#ifndef IR_SEND_ASYNC
+#define IR_SEND_ASYNC  0
+#endif
+
+#if IR_SEND_ASYNC
+#	ifndef IR_USE_TIMER2
+#		error "IR_SEND_ASYNC needs Timer2 [IR_USE_TIMER2]"
+#	endif
+
+// Frames that can wait to be sent.  Must be a power of two.
+#ifndef IR_SEND_QUEUE
+#define IR_SEND_QUEUE  4
+#endif
+
+#if (IR_SEND_QUEUE & (IR_SEND_QUEUE - 1))
+#	error "IR_SEND_QUEUE must be a power of two"
+#endif
+
+// Map a free-running frame counter on to an index in irsendparams.frame[]
+#define IR_SEND_SLOT(n)  ((uint8_t)(n) & (IR_SEND_QUEUE - 1))
+
+class IRencoder;
+
+typedef
+	struct {
+		const unsigned int  *buf;      // Durations in uS, MARK first
+		IRencoder     *enc;            // Gives the durations instead; NULL = buf
+		uint8_t       len;             // Number of them
+		uint8_t       khz;             // Carrier
+		uint8_t       progmem;         // true -> buf is in PROGMEM
+		unsigned int  scale;           // Carrier periods per uS, times 65536
+	}
+irframe_t;
+
+typedef
+	struct {
+		uint8_t       head;            // Frames queued    [only sendRawAsync() writes this]
+		uint8_t       tail;            // Frames finished  [only the ISR writes this]
+		unsigned int  index;           // Duration of frame[tail] being sent
+		unsigned int  periods;         // Carrier periods left of it
+		uint8_t       relay;           // IRrecv::relay() carrier for captured frames; 0 = Not relaying
+		uint8_t       excess;          // true -> Correct relayed frames for MARK_EXCESS
+		uint8_t       relayed;         // Captured slots queued and not yet sent
+		irframe_t     frame[IR_SEND_QUEUE];
+	}
+irsendparams_t;
+
+EXTERN  volatile irsendparams_t  irsendparams;
+
+// Run by the timer ISR, once per carrier period, while a frame is queued
+void  IRsendTick ( ) ;
+
+// Run as the receiver completes a slot, while relaying; false -> Queue full
+bool  IRrelaySlot ( ) ;
+#endif // IR_SEND_ASYNC
+
 #endif
@@ -62,6 +62,45 @@
 // microseconds per clock interrupt tick
 #define USECPERTICK    50
 
+//------------------------------------------------------------------------------
+// Receive pin
+//
+// Set IR_RECV_PIN to the Arduino pin the IR detector is wired to and, on the
+//   boards listed below, the ISR samples it with a single port read (an
+//   "sbis" on AVR) instead of a call to digitalRead().
+// The pin passed to the IRrecv constructor must then be the same pin [it is
+//   asserted there].
+// It has to reach every file of the library, so set it in the build flags
+//   [eg. -DIR_RECV_PIN=11 for the curtain controller's detector], not in a
+//   sketch, and as a plain number.  Leave it undefined to pick the pin at run
+//   time (slower, but portable).
+// In edge mode (IR_RECV_EDGE) on these boards it also picks the interrupt :
+//   The external one of D2 and D3 [IR_RECV_INT], or else the one pin-change
+//   vector the library takes [IR_RECV_PCINT].  Edge mode needs one of them.
+//
+//#define IR_RECV_PIN  11
+
+#if defined(IR_RECV_PIN) && ( \
+	defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || \
+	defined(__AVR_ATmega168__)  || defined(__AVR_ATmega168P__) || \
+	defined(__AVR_ATmega88__)   || defined(__AVR_ATmega48__) )
+	// Arduino Uno, Nano, Pro Mini, etc: D0-D7 = PORTD, D8-D13 = PORTB, A0-A5 = PORTC
+#	define IR_RECV_PINREG  (((IR_RECV_PIN) < 8) ? PIND : (((IR_RECV_PIN) < 14) ? PINB : PINC))
+#	define IR_RECV_PINBIT  (((IR_RECV_PIN) < 8) ? (IR_RECV_PIN) : (((IR_RECV_PIN) < 14) ? (IR_RECV_PIN) - 8 : (IR_RECV_PIN) - 14))
+#	define IR_READ_RECV()  ((IR_RECV_PINREG & _BV(IR_RECV_PINBIT)) ? SPACE : MARK)
+#	if ((IR_RECV_PIN) == 2) || ((IR_RECV_PIN) == 3)
+#		define IR_RECV_INT  ((IR_RECV_PIN) - 2)  // INT0, INT1
+#	elif (IR_RECV_PIN) < 8
+#		define IR_RECV_PCINT  PCINT2_vect
+#	elif (IR_RECV_PIN) < 14
+#		define IR_RECV_PCINT  PCINT0_vect
+#	else
+#		define IR_RECV_PCINT  PCINT1_vect
+#	endif
+#else
+#	define IR_READ_RECV()  ((uint8_t)digitalRead(irparams.recvpin))
+#endif
+
 //------------------------------------------------------------------------------
 // Define which timer to use
 //
@@ -171,6 +210,9 @@
 
 #define TIMER_COUNT_TOP  (SYSCLOCK * USECPERTICK / 1000000)
 
+// One compare interrupt per carrier period, of this many clocks, while sending
+#define TIMER_CARRIER_CLOCKS  (2 * OCR2A)
+
 //-----------------
 #if (TIMER_COUNT_TOP < 256)
 #	define TIMER_CONFIG_NORMAL() ({ \
@@ -186,6 +228,12 @@
 		OCR2A  = TIMER_COUNT_TOP / 8; \
 		TCNT2  = 0; \
 	})
+#	if IR_ADAPTIVE_RATE
+		// Same OCR2A at clk/32 : one interrupt every 4 ticks between frames
+#		define TIMER_IDLE_TICKS     4
+#		define TIMER_CONFIG_IDLE()  (TCCR2B = _BV(CS21) | _BV(CS20))
+#		define TIMER_CONFIG_BUSY()  (TCCR2B = _BV(CS21))
+#	endif
 #endif
 
 //-----------------
@@ -574,4 +622,13 @@
 #	error "Internal code configuration error, no known IR_USE_TIMER# defined\n"
 #endif
 
+//---------------------------------------------------------
+// Timers without a coarser idle rate sample every tick all the time
+//
+#ifndef TIMER_IDLE_TICKS
+#	define TIMER_IDLE_TICKS     1
+#	define TIMER_CONFIG_IDLE()  do {} while (0)
+#	define TIMER_CONFIG_BUSY()  do {} while (0)
+#endif
+
 #endif // ! boarddefs_h
@@ -0,0 +1,343 @@
+//------------------------------------------------------------------------------
+// IRbench : How fast, and how accurately, IRrecv::decode() decodes
+//
+// Replays the captures in captures.h through decode(), PASSES times each,
+// with noise added, and reports over Serial:
+//   - the time decode() takes per frame
+//   - per capture : how often it decoded right, wrong, only hashed, or was lost
+//   - decodeHash() : captures that share a hash, and how often a noisy frame
+//     that only hashed kept its own hash or took another capture's
+//   - with IR_DECODE_CACHE : how many of the frames, each the same capture as
+//     the one before bar the noise, decode() answered from its cache
+//
+// No IR hardware is needed : The receiver is never enabled, the frames are put
+// in its capture slots here, just as the ISR would.
+//
+// It also builds on a PC, with the stand-ins for the Arduino core in host/ :
+//   make                 : Builds ./irbench [DEFS="-DJITTER_PCT=0 ..." to set
+//                          the options below, or the library's]
+//   ./irbench            : Replays captures.h
+//   ./irbench dump.txt   : Replays the captures in what IRrecvDumpV2 printed
+// The decode() time is then the PC's, in nS.
+//
+#include <IRremote.h>
+
+#ifndef TEST
+#define TEST  0
+#endif
+
+//------------------------------------------------------------------------------
+// Noise added to each replayed frame [all 0 replays the captures as they are]
+//
+#ifndef JITTER_PCT
+#define JITTER_PCT  10   // Each duration is off by up to this many percent
+#endif
+#ifndef DROP_PCT
+#define DROP_PCT     0   // Chance of a SPACE being lost [the MARKs either side merge]
+#endif
+#ifndef SPIKE_PCT
+#define SPIKE_PCT    0   // Chance of a one-tick break in a duration [ambient IR in a SPACE, a dropout in a MARK]
+#endif
+#ifndef PASSES
+#define PASSES      50   // Times each capture is replayed
+#endif
+
+typedef
+  struct {
+    int8_t               type;    // What it should decode as
+    unsigned long        value;
+    const unsigned int  *timing;  // uS, as IRrecvDumpV2 prints them [PROGMEM]
+    uint8_t              len;
+  }
+capture_t;
+
+#if TEST
+#  define CAPTURES_MAX  100
+capture_t     captures[CAPTURES_MAX];  // Read from a file by main()
+int           captureCount;
+#  define CAPTURES      captureCount
+#else
+#  include "captures.h"
+#  define CAPTURES_MAX  CAPTURES
+#endif
+
+// What decode() is timed with
+#if TEST
+#  define CLOCK()   nanos()
+#  define CLOCK_NS  1      // nS per CLOCK() count
+#else
+#  define CLOCK()   micros()
+#  define CLOCK_NS  1000
+#endif
+
+IRrecv          irrecv(11);
+decode_results  results;
+
+unsigned long  hashes[CAPTURES_MAX];  // Hash of each capture without noise
+
+//+=============================================================================
+// Protocol name, as IRrecvDumpV2 prints it
+//
+const char *  encoding (int8_t type)
+{
+  switch (type) {
+    default:
+    case UNKNOWN:      return "UNKNOWN";
+    case NEC:          return "NEC";
+    case SONY:         return "SONY";
+    case RC5:          return "RC5";
+    case RC6:          return "RC6";
+    case DISH:         return "DISH";
+    case SHARP:        return "SHARP";
+    case JVC:          return "JVC";
+    case SANYO:        return "SANYO";
+    case MITSUBISHI:   return "MITSUBISHI";
+    case SAMSUNG:      return "SAMSUNG";
+    case LG:           return "LG";
+    case WHYNTER:      return "WHYNTER";
+    case AIWA_RC_T501: return "AIWA_RC_T501";
+    case PANASONIC:    return "PANASONIC";
+    case DENON:        return "Denon";
+  }
+}
+
+//+=============================================================================
+// Store one duration in a capture slot, the way the ISR does
+//
+void  store (volatile irslot_t *slot,  unsigned int ticks)
+{
+#if IR_COMPACT_RAWBUF
+  if (ticks >= IR_RAW_ESCAPE) {
+    if (slot->rawlongs < IR_RAW_LONGS) {
+      slot->rawlong[slot->rawlongs] = ticks;
+      ticks = IR_RAW_ESCAPE + slot->rawlongs++;
+    } else {
+      ticks = IR_RAW_ESCAPE - 1;
+    }
+  }
+#endif
+  if (slot->rawlen < RAWBUF)  slot->rawbuf[slot->rawlen++] = ticks ;
+  else                        slot->overflow = true ;
+}
+
+//+=============================================================================
+// Hand a capture to decode(), with noise, as if the ISR had just received it
+//
+void  replay (int c,  bool noise)
+{
+  capture_t           cap;
+  unsigned int        ticks[RAWBUF];
+  int                 len = 0;
+  volatile irslot_t  *slot = &irparams.slot[IR_SLOT(irparams.head)];
+
+  memcpy_P(&cap, &captures[c], sizeof(cap));
+
+  for (int i = 0;  (i < cap.len) && (len < RAWBUF - 1);  i++) {
+    unsigned int  t = pgm_read_word(&cap.timing[i]) / USECPERTICK;
+
+    if (noise) {
+      t += (long)t * random(-JITTER_PCT, JITTER_PCT + 1) / 100;
+      if (t < 1)  t = 1 ;
+
+      // A lost SPACE : It, and the MARK after it, add on to the MARK before
+      if ((i & 1) && (i + 1 < cap.len) && (random(100) < DROP_PCT)) {
+        ticks[len - 1] += t + pgm_read_word(&cap.timing[++i]) / USECPERTICK;
+        continue;
+      }
+
+      // A spike : SPACE, short MARK, SPACE [or a dropout : MARK, short SPACE, MARK]
+      if ((t > 4) && (len < RAWBUF - 3) && (random(100) < SPIKE_PCT)) {
+        ticks[len++] = t / 2;
+        ticks[len++] = 1;
+        t -= t / 2 + 1;
+      }
+    }
+    ticks[len++] = t;
+  }
+
+  slot->rawlen   = 0;
+  slot->overflow = false;
+  slot->stamp    = millis();
+#if IR_COMPACT_RAWBUF
+  slot->rawlongs = 0;
+#endif
+#if IR_RECV_STREAM
+  slot->streamed = false;
+#endif
+  store(slot, 1000);  // The gap before it [50mS; Sony takes shorter ones for repeats]
+  for (int i = 0;  i < len;  i++)  store(slot, ticks[i]) ;
+
+  irparams.head++;  // Hand the slot to decode()
+}
+
+//+=============================================================================
+void  printPercent (unsigned int count,  unsigned int total)
+{
+  Serial.print((100.0 * count) / total, 1);
+  Serial.print("%  ");
+}
+
+//+=============================================================================
+void  setup ( )
+{
+  unsigned int   collisions = 0;
+  unsigned long  frames     = 0;
+  unsigned long  time       = 0;
+
+  Serial.begin(9600);
+  randomSeed(1);  // The same noise every run
+
+  Serial.print("IRbench : ");
+  Serial.print(CAPTURES);
+  Serial.print(" captures, ");
+  Serial.print(PASSES);
+  Serial.print(" passes, jitter ");
+  Serial.print(JITTER_PCT);
+  Serial.print("%, dropped spaces ");
+  Serial.print(DROP_PCT);
+  Serial.print("%, spikes ");
+  Serial.print(SPIKE_PCT);
+  Serial.println("%");
+
+  // The hash of each capture, as it is
+  for (int c = 0;  c < CAPTURES;  c++) {
+    replay(c, false);
+    irrecv.capture(&results);
+    hashes[c] = irrecv.fingerprint(&results, NULL) ? results.value : 0 ;  // 0 : Too short to hash
+    irrecv.resume();
+    for (int k = 0;  k < c;  k++)  if (hashes[c] && (hashes[k] == hashes[c]))  collisions++ ;
+  }
+  Serial.print("Captures with the same hash as an earlier one : ");
+  Serial.println(collisions);
+  Serial.println("");
+
+  Serial.println("Capture\t\tright   wrong   hashed  lost    [of hashed: own hash  other's hash]");
+  for (int c = 0;  c < CAPTURES;  c++) {
+    capture_t     cap;
+    unsigned int  right = 0, wrong = 0, hashed = 0, lost = 0, same = 0, other = 0;
+
+    memcpy_P(&cap, &captures[c], sizeof(cap));
+
+    for (int pass = 0;  pass < PASSES;  pass++) {
+      unsigned long  start;
+      bool           decoded;
+
+      replay(c, true);
+      start   = CLOCK();
+      decoded = irrecv.decode(&results);
+      time   += CLOCK() - start;
+      frames++;
+      if (!decoded)  { lost++;  continue; }  // Too short even to hash; decode() has resumed
+
+      if (results.decode_type == UNKNOWN) {
+        hashed++;
+        for (int k = 0;  k < CAPTURES;  k++) {
+          if (!hashes[k] || (results.value != hashes[k]))  continue ;
+          if (k == c)  same++ ;
+          else         other++ ;
+          break;
+        }
+      }
+      // Values are 32 bits [long is 64 on a PC]
+      if ((results.decode_type == cap.type) && ((cap.type == UNKNOWN) || ((uint32_t)results.value == (uint32_t)cap.value)))  right++ ;
+      else if (results.decode_type != UNKNOWN)                                                                                  wrong++ ;
+      irrecv.resume();
+    }
+
+    Serial.print(encoding(cap.type));
+    Serial.print(" ");
+    Serial.print(cap.value, HEX);
+    Serial.print("\t");
+    printPercent(right,  PASSES);
+    printPercent(wrong,  PASSES);
+    printPercent(hashed, PASSES);
+    printPercent(lost,   PASSES);
+    if (hashed)  { printPercent(same, hashed);  printPercent(other, hashed); }
+    Serial.println("");
+  }
+
+  Serial.println("");
+  Serial.print("decode() : ");
+  Serial.print(((double)CLOCK_NS * time) / frames, 0);
+  Serial.println(" ns per frame");
+#if IR_DECODE_CACHE
+  Serial.print("decode() cache : ");
+  Serial.print(irrecv.cacheHits());
+  Serial.print(" hits, ");
+  Serial.print(irrecv.cacheMisses());
+  Serial.println(" misses");
+#endif
+}
+
+void  loop ( )
+{
+}
+
+#if TEST
+//+=============================================================================
+// PC build : Load the captures from what IRrecvDumpV2 printed
+// Each line like
+//   unsigned int  rawData[67] = {8950,4500, 600,550, ...};  // NEC 20DF10EF
+// is a capture, that should decode as the protocol and value in its comment
+// [After a ':', for the ones printed with an address].  captures.h is in
+// this form too.  Returns the number of captures, or -1 if there is no file.
+//
+int  loadCaptures (const char *name)
+{
+  FILE  *fp = fopen(name, "r");
+  char   line[4096];
+
+  if (!fp)  return -1 ;
+
+  captureCount = 0;
+  while (fgets(line, sizeof(line), fp) && (captureCount < CAPTURES_MAX)) {
+    char          *cp = strchr(line, '{');
+    char          *end;
+    char          *comment;
+    unsigned int  *timing;
+    capture_t     *cap = &captures[captureCount];
+
+    if (!cp || !strchr(line, '[') || !(end = strchr(cp, '}')) || !(comment = strstr(end, "//")))  continue ;
+
+    // Durations
+    timing   = (unsigned int *)malloc(RAWBUF * sizeof(*timing));
+    cap->len = 0;
+    for (cp++;  (cp < end) && (cap->len < RAWBUF - 1);  ) {
+      unsigned long  t = strtoul(cp, &cp, 10);
+
+      timing[cap->len++] = t;
+      while ((cp < end) && ((*cp == ',') || (*cp == ' ')))  cp++ ;
+    }
+    cap->timing = timing;
+
+    // Protocol, and value
+    cp = strtok(comment + 2, " \t\r\n");
+    cap->type = UNKNOWN;
+    for (int type = UNKNOWN;  cp && (type <= LEGO_PF);  type++) {
+      if (!strcmp(cp, encoding(type)))  { cap->type = type;  break; }
+    }
+    cp = strtok(NULL, " \t\r\n");
+    cap->value = 0;
+    if (cp)  cap->value = strtoul(strchr(cp, ':') ? strchr(cp, ':') + 1 : cp, NULL, 16) ;
+
+    if (cap->len)  captureCount++ ;
+  }
+
+  fclose(fp);
+  return captureCount;
+}
+
+//+=============================================================================
+int  main (int argc,  char *argv[])
+{
+  const char  *name = (argc > 1) ? argv[1] : "captures.h";
+
+  if (loadCaptures(name) <= 0) {
+    fprintf(stderr, "%s : No IRrecvDumpV2 captures\n", name);
+    return 1;
+  }
+
+  setup();
+  return 0;
+}
+#endif // TEST
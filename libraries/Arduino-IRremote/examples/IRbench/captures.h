@@ -0,0 +1,51 @@
+//------------------------------------------------------------------------------
+// Captures replayed by IRbench
+//
+// Each one is a line printed by IRrecvDumpV2, renamed and put in PROGMEM,
+// plus an entry in captures[] with what it should decode as.
+// To add your own remote: run IRrecvDumpV2, press the buttons, paste the
+// "rawData" lines here and list them below.
+//
+// These are the library's own senders, received through the ISR.  Denon's
+// came through the edge ISR [IR_RECV_EDGE] : Sampled by the timer, its 300uS
+// MARKs come out at 250uS as often as not, which is too short for its decoder
+// [a real receiver stretches them by about MARK_EXCESS].
+//
+
+const unsigned int  necPower[67] PROGMEM = {8950,4500, 600,550, 550,550, 550,1700, 550,550, 550,550, 600,550, 550,550, 550,550, 550,1700, 550,1700, 550,550, 550,1700, 550,1700, 550,1700, 550,1700, 550,1700, 550,550, 550,550, 550,550, 600,1650, 600,550, 550,550, 550,550, 550,550, 600,1650, 600,1650, 550,1700, 550,550, 600,1650, 550,1700, 550,1700, 550,1700, 550};  // NEC 20DF10EF
+const unsigned int  necMute[67] PROGMEM = {8950,4500, 600,550, 550,550, 550,1700, 550,550, 550,550, 600,550, 550,550, 550,550, 550,1700, 550,1700, 550,550, 550,1700, 550,1700, 550,1700, 550,1700, 550,1700, 550,1700, 550,550, 550,550, 550,1700, 550,550, 550,600, 550,550, 550,550, 550,550, 600,1650, 550,1700, 550,550, 600,1650, 550,1700, 550,1700, 550,1700, 550};  // NEC 20DF906F
+const unsigned int  necRepeat[3] PROGMEM = {8950,2250, 600};  // NEC FFFFFFFF
+const unsigned int  samsungPower[67] PROGMEM = {4950,5000, 600,1550, 600,1600, 550,1600, 550,550, 550,550, 550,550, 600,550, 550,550, 550,1600, 550,1600, 550,1600, 550,600, 550,550, 550,550, 550,550, 600,550, 550,550, 550,1600, 550,550, 550,600, 550,550, 550,550, 550,550, 600,550, 550,1600, 550,550, 550,1600, 550,1600, 550,1600, 550,1600, 600,1550, 600,1600, 550};  // SAMSUNG E0E040BF
+const unsigned int  sonyPower[25] PROGMEM = {2350,600, 1200,600, 600,600, 1200,600, 600,600, 1200,600, 600,600, 600,600, 1150,600, 600,600, 600,600, 600,600, 600};  // SONY A90
+const unsigned int  rc5Power[23] PROGMEM = {850,900, 900,850, 1800,900, 850,900, 900,850, 900,900, 900,850, 900,900, 850,1800, 900,850, 1800,850, 900};  // RC5 80C
+const unsigned int  rc6Power[39] PROGMEM = {2650,850, 450,900, 450,450, 400,450, 1350,1300, 450,450, 450,450, 400,450, 450,450, 450,400, 450,450, 450,450, 450,400, 450,450, 450,450, 400,450, 900,450, 450,850, 450,450, 450};  // RC6 1000C
+const unsigned int  rc6Mce[67] PROGMEM = {2650,850, 450,450, 450,450, 450,850, 450,900, 1300,900, 450,450, 450,400, 450,450, 450,450, 400,450, 450,450, 450,450, 400,450, 450,450, 450,400, 900,450, 450,450, 400,450, 450,900, 450,400, 450,450, 450,450, 450,400, 900,900, 450,400, 450,450, 450,450, 400,450, 450,450, 900,400, 450,900, 450,450, 400};  // RC6 C:800F040C [36 bits, MCE; sent with sendRaw()]
+const unsigned int  panasonicPower[99] PROGMEM = {3450,1750, 500,400, 500,1250, 500,400, 500,400, 500,400, 500,400, 500,400, 500,400, 500,400, 500,350, 500,400, 500,400, 500,400, 500,1250, 500,400, 500,400, 500,400, 500,400, 500,400, 500,400, 500,350, 500,400, 500,400, 500,1250, 500,400, 500,400, 500,400, 500,400, 500,400, 500,400, 500,400, 500,350, 500,1250, 500,400, 500,1250, 500,1250, 500,1250, 500,1200, 500,400, 500,400, 500,1250, 500,400, 500,1250, 500,1250, 500,1200, 500,1250, 500,400, 500,1250, 500};  // PANASONIC 4004:100BCBD
+const unsigned int  jvcPower[35] PROGMEM = {7950,4000, 600,1600, 600,1600, 600,550, 600,550, 600,550, 600,1600, 600,550, 550,1600, 600,1600, 600,1600, 600,1600, 600,550, 600,1600, 600,550, 600,550, 600,500, 600};  // JVC C5E8
+const unsigned int  lgPower[59] PROGMEM = {7950,4000, 600,1600, 600,550, 600,550, 600,550, 600,1600, 600,550, 600,550, 550,550, 600,1600, 600,1600, 600,550, 600,550, 600,550, 600,550, 600,550, 600,500, 600,550, 600,550, 600,550, 600,550, 600,550, 600,1600, 600,550, 600,1550, 600,550, 600,550, 600,550, 600,1600, 600};  // LG 88C0051
+const unsigned int  whynterPower[69] PROGMEM = {700,750, 2850,2850, 750,2150, 750,750, 750,750, 750,750, 750,750, 750,2150, 700,2150, 750,2150, 750,750, 750,2150, 750,2150, 750,750, 750,750, 750,2150, 750,700, 750,2150, 750,750, 750,2150, 750,750, 750,750, 750,750, 750,750, 750,2100, 750,2150, 750,750, 750,750, 750,2150, 750,750, 750,750, 750,750, 750,750, 700,2150, 750};  // WHYNTER 87654321
+const unsigned int  denonPower[31] PROGMEM = {300,750, 300,1800, 300,750, 300,1800, 300,750, 300,1800, 300,750, 300,750, 300,1800, 300,750, 300,750, 300,1800, 300,1800, 300,750, 300,750, 300};  // Denon 2A4C [received with IR_RECV_EDGE, see above]
+const unsigned int  unknownPower[51] PROGMEM = {3250,1700, 450,450, 450,1300, 450,1300, 450,1300, 450,1300, 450,450, 450,1300, 400,450, 450,450, 450,1300, 450,450, 450,1300, 450,1300, 450,450, 450,1300, 450,400, 450,450, 450,1300, 450,450, 450,1300, 450,1300, 450,450, 450,1300, 450,400, 450};  // UNKNOWN 626200A3
+
+// What each capture should decode as
+// UNKNOWN : Should only hash; Its value is not checked [the hash is]
+#define CAPTURE(type, value, timing)  { type, value, timing, sizeof(timing) / sizeof(timing[0]) }
+
+const capture_t  captures[] PROGMEM = {
+  CAPTURE(NEC,       0x20DF10EF, necPower),
+  CAPTURE(NEC,       0x20DF906F, necMute),
+  CAPTURE(NEC,       REPEAT,     necRepeat),
+  CAPTURE(SAMSUNG,   0xE0E040BF, samsungPower),
+  CAPTURE(SONY,      0xA90,      sonyPower),
+  CAPTURE(RC5,       0x80C,      rc5Power),
+  CAPTURE(RC6,       0x1000C,    rc6Power),
+  CAPTURE(RC6,       0x800F040C, rc6Mce),
+  CAPTURE(PANASONIC, 0x100BCBD,  panasonicPower),
+  CAPTURE(JVC,       0xC5E8,     jvcPower),
+  CAPTURE(LG,        0x88C0051,  lgPower),
+  CAPTURE(WHYNTER,   0x87654321, whynterPower),
+  CAPTURE(DENON,     0x2A4C,     denonPower),
+  CAPTURE(UNKNOWN,   0,          unknownPower),
+};
+
+#define CAPTURES  (sizeof(captures) / sizeof(captures[0]))
@@ -0,0 +1,125 @@
+//******************************************************************************
+// Stand-in for the Arduino core [see Arduino.h]
+// micros() and millis() run off the PC's clock, until a simulation sets them
+// with setMicros().  digitalRead() reads the PINx registers, as on a Nano.
+//******************************************************************************
+#include <Arduino.h>
+#include <time.h>
+
+volatile uint8_t  SREG, TCCR2A, TCCR2B, OCR2A, OCR2B, TCNT2, TIMSK2, TIFR2;
+volatile uint8_t  PCICR, PCIFR, PCMSK0, PCMSK1, PCMSK2, EIMSK, EIFR;
+volatile uint8_t  PINB = 0xFF, PINC = 0xFF, PIND = 0xFF, PORTB, PORTC, PORTD, DDRB, DDRC, DDRD;
+
+HardwareSerial  Serial;
+
+void  pinMode         (uint8_t,  uint8_t)             { }
+void  digitalWrite    (uint8_t,  uint8_t)             { }
+void  attachInterrupt (uint8_t,  void (*)(void),  int)  { }
+void  detachInterrupt (uint8_t)                       { }
+int   analogRead      (uint8_t)                       { return 0; }
+
+//+=============================================================================
+// The pins read as idle [HIGH] until a simulation drives them
+//
+int  digitalRead (uint8_t pin)
+{
+	volatile uint8_t  *reg = (pin < 8) ? &PIND : ((pin < 14) ? &PINB : &PINC);
+
+	return (*reg >> digitalPinToPCMSKbit(pin)) & 1;
+}
+
+//+=============================================================================
+// Time since the first call, or where setMicros() stopped it.  Stopped, with a
+// clockHook, each call to micros() takes a uS [so the library's busy-waits
+// end], and the hook sees each uS go by.
+//
+static bool           stopped = false;
+static unsigned long  stoppedAt;  // uS
+
+void  (*clockHook)(unsigned long usec) = NULL;
+
+void  setMicros (unsigned long usec)
+{
+	stopped   = true;
+	stoppedAt = usec;
+}
+
+unsigned long  nanos ( )
+{
+	static struct timespec  start;
+	struct timespec         now;
+
+	if (stopped)  return stoppedAt * 1000 ;
+	if (!start.tv_sec && !start.tv_nsec)  clock_gettime(CLOCK_MONOTONIC, &start) ;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start.tv_sec) * 1000000000UL + now.tv_nsec - start.tv_nsec;
+}
+
+unsigned long  micros ( )
+{
+	if (stopped && clockHook) {
+		unsigned long  usec = stoppedAt++;
+
+		clockHook(stoppedAt);
+		return usec;
+	}
+	return nanos() / 1000;
+}
+
+unsigned long  millis ( )  { return micros() / 1000; }
+
+void  delay (unsigned long ms)
+{
+	unsigned long  start = micros();
+
+	if (stopped && !clockHook)  { stoppedAt += ms * 1000;  return; }
+	while (micros() - start < ms * 1000) ;
+}
+
+void  delayMicroseconds (unsigned int usec)
+{
+	unsigned long  start = micros();
+
+	if (stopped && !clockHook)  { stoppedAt += usec;  return; }
+	while (micros() - start < usec) ;
+}
+
+//+=============================================================================
+// The same sequence on every PC for a given seed
+//
+static unsigned long  seed = 1;
+
+void  randomSeed (unsigned long s)  { seed = s ? s : 1; }
+
+long  random (long howbig)
+{
+	if (howbig <= 0)  return 0 ;
+	seed = seed * 1103515245UL + 12345;
+	return (long)((seed >> 16) & 0x7FFF) % howbig;
+}
+
+long  random (long howsmall,  long howbig)
+{
+	if (howsmall >= howbig)  return howsmall ;
+	return random(howbig - howsmall) + howsmall;
+}
+
+//+=============================================================================
+// Print n in the given base, as the Arduino core does [no leading zeroes]
+//
+size_t  HardwareSerial::print (unsigned long n,  int base)
+{
+	char    buf[8 * sizeof(n) + 1];
+	char   *cp = &buf[sizeof(buf) - 1];
+
+	if (base < 2)  base = DEC ;
+	*cp = '\0';
+	do {
+		int  digit = n % base;
+
+		*--cp = (digit < 10) ? ('0' + digit) : ('A' + digit - 10);
+		n /= base;
+	} while (n);
+
+	return print(cp);
+}
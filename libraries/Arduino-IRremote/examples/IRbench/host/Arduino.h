@@ -0,0 +1,107 @@
+//******************************************************************************
+// Stand-in for the Arduino core, so IRbench and the library build on a PC
+// [see the top of IRbench.ino].  Only what they use : The registers are plain
+// variables, and nothing runs the ISRs but the simulations in test/.
+// The library is built as for a Nano [ATmega328P].
+//******************************************************************************
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#define __AVR_ATmega328P__  1
+
+typedef  bool     boolean;
+typedef  uint8_t  byte;
+
+#define HIGH          1
+#define LOW           0
+#define INPUT         0
+#define OUTPUT        1
+#define INPUT_PULLUP  2
+#define CHANGE        1
+#define DEC          10
+#define HEX          16
+#define BIN           2
+
+#define B00000001  0x01
+#define B00100000  0x20
+#define B01111111  0x7F
+#define B10000000  0x80
+#define B11011111  0xDF
+#define B11111110  0xFE
+
+#define _BV(b)  (1u << (b))
+#define min(a, b)  ((a) < (b) ? (a) : (b))
+#define max(a, b)  ((a) > (b) ? (a) : (b))
+#define F(s)    (s)
+
+#define PROGMEM
+#define PSTR(s)               (s)
+#define pgm_read_byte(p)      (*(const uint8_t *)(p))
+#define pgm_read_word(p)      (*(const uint16_t *)(p))
+#define pgm_read_dword(p)     (*(const uint32_t *)(p))
+#define pgm_read_ptr(p)       (*(void * const *)(p))
+#define memcpy_P              memcpy
+
+#define ISR(vector)  extern "C" void  vector (void)
+#define cli()
+#define sei()
+#define noInterrupts()
+#define interrupts()
+
+// Timer 2, the pin-change groups and the ports
+extern volatile uint8_t  SREG, TCCR2A, TCCR2B, OCR2A, OCR2B, TCNT2, TIMSK2, TIFR2;
+extern volatile uint8_t  PCICR, PCIFR, PCMSK0, PCMSK1, PCMSK2, EIMSK, EIFR;
+extern volatile uint8_t  PINB, PINC, PIND, PORTB, PORTC, PORTD, DDRB, DDRC, DDRD;
+enum { CS20, CS21, CS22, WGM20 = 0, WGM21, WGM22 = 3, COM2B1 = 5, OCIE2A = 1, OCIE2B = 2, OCF2B = 2 };
+
+#define NOT_AN_INTERRUPT                -1
+#define digitalPinToInterrupt(p)        (((p) == 2) ? 0 : (((p) == 3) ? 1 : NOT_AN_INTERRUPT))
+#define digitalPinToPCICR(p)            (&PCICR)
+#define digitalPinToPCICRbit(p)         (((p) <= 7) ? 2 : (((p) <= 13) ? 0 : 1))
+#define digitalPinToPCMSK(p)            (((p) <= 7) ? &PCMSK2 : (((p) <= 13) ? &PCMSK0 : &PCMSK1))
+#define digitalPinToPCMSKbit(p)         (((p) <= 7) ? (p) : (((p) <= 13) ? (p) - 8 : (p) - 14))
+
+void           pinMode           (uint8_t pin,  uint8_t mode) ;
+void           digitalWrite      (uint8_t pin,  uint8_t val) ;
+int            digitalRead       (uint8_t pin) ;
+int            analogRead        (uint8_t pin) ;
+void           attachInterrupt   (uint8_t irq,  void (*isr)(void),  int mode) ;
+void           detachInterrupt   (uint8_t irq) ;
+unsigned long  millis            ( ) ;
+unsigned long  micros            ( ) ;
+void           delay             (unsigned long ms) ;
+void           delayMicroseconds (unsigned int usec) ;
+long           random            (long howbig) ;
+long           random            (long howsmall,  long howbig) ;
+void           randomSeed        (unsigned long seed) ;
+unsigned long  nanos             ( ) ;  // PC only : nS since the first call
+void           setMicros         (unsigned long usec) ;  // PC only : Stop the clock at usec [for simulations]
+extern void  (*clockHook)(unsigned long usec) ;            // PC only : Stopped, micros() ticks the clock and calls this
+
+// Serial : Prints to stdout
+class HardwareSerial
+{
+	public:
+		void    begin   (unsigned long)  { }
+		size_t  print   (const char *s)  { return printf("%s", s); }
+		size_t  print   (char c)         { return printf("%c", c); }
+		size_t  print   (unsigned long n,  int base = DEC) ;
+		size_t  print   (long n,  int base = DEC)          { return (n < 0) ? print('-') + print((unsigned long)-n, base) : print((unsigned long)n, base); }
+		size_t  print   (unsigned int n,  int base = DEC)  { return print((unsigned long)n, base); }
+		size_t  print   (int n,  int base = DEC)           { return print((long)n, base); }
+		size_t  print   (double n,  int digits = 2)        { return printf("%.*f", digits, n); }
+		size_t  println ( )                               { return print("\r\n"); }
+
+		template <typename T>  size_t  println (T x)          { return print(x) + println(); }
+		template <typename T>  size_t  println (T x,  int f)  { return print(x, f) + println(); }
+};
+
+extern HardwareSerial  Serial;
+
+#endif // Arduino_h
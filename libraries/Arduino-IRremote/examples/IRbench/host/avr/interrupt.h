@@ -0,0 +1,2 @@
+// Stand-in for avr-libc's header : ISR() and cli()/sei() are in Arduino.h
+#include <Arduino.h>
@@ -75,11 +75,11 @@ void dump(decode_results *results) {
 
   for (int i = 1; i < count; i++) {
     if (i & 1) {
-      Serial.print(results->rawbuf[i]*USECPERTICK, DEC);
+      Serial.print(results->rawAt(i)*USECPERTICK, DEC);
     }
     else {
       Serial.write('-');
-      Serial.print((unsigned long) results->rawbuf[i]*USECPERTICK, DEC);
+      Serial.print((unsigned long) results->rawAt(i)*USECPERTICK, DEC);
     }
     Serial.print(" ");
   }
@@ -29,6 +29,21 @@ void  ircode (decode_results *results)
     Serial.print(":");
   }
 
+#if IR_RESULT_BITS
+  // Longer than value holds [RC6 MCE ...] : Every bit, in hex
+  else if ((results->bits > 32) && (results->bits <= IR_RESULT_BITS)) {
+    uint8_t  digit = 0;
+    for (int i = 0;  i < results->bits;  i++) {
+      digit = (digit << 1) | results->data.get(i);
+      if ((results->bits - 1 - i) % 4 == 0) {
+        Serial.print(digit, HEX);
+        digit = 0;
+      }
+    }
+    return;
+  }
+#endif
+
   // Print Code
   Serial.print(results->value, HEX);
 }
@@ -94,7 +109,7 @@ void  dumpRaw (decode_results *results)
   Serial.println("]: ");
 
   for (int i = 1;  i < results->rawlen;  i++) {
-    unsigned long  x = results->rawbuf[i] * USECPERTICK;
+    unsigned long  x = results->rawAt(i) * USECPERTICK;
     if (!(i & 1)) {  // even
       Serial.print("-");
       if (x < 1000)  Serial.print(" ") ;
@@ -126,7 +141,7 @@ void  dumpCode (decode_results *results)
 
   // Dump data
   for (int i = 1;  i < results->rawlen;  i++) {
-    Serial.print(results->rawbuf[i] * USECPERTICK, DEC);
+    Serial.print(results->rawAt(i) * USECPERTICK, DEC);
     if ( i < results->rawlen-1 ) Serial.print(","); // ',' not needed on last one
     if (!(i & 1))  Serial.print(" ");
   }
@@ -48,10 +48,10 @@ void dump(decode_results *results) {
 
   for (int i = 0; i < count; i++) {
     if ((i % 2) == 1) {
-      Serial.print(results->rawbuf[i]*USECPERTICK, DEC);
+      Serial.print(results->rawAt(i)*USECPERTICK, DEC);
     } 
     else {
-      Serial.print(-(int)results->rawbuf[i]*USECPERTICK, DEC);
+      Serial.print(-(int)results->rawAt(i)*USECPERTICK, DEC);
     }
     Serial.print(" ");
   }
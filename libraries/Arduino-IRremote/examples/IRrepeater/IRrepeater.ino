@@ -0,0 +1,43 @@
+/*
+ * IRremote: IRrepeater - sends every frame it receives straight back out
+ * An IR detector/demodulator must be connected to the input RECV_PIN, and an
+ * IR LED to the send pin [3 on an Uno].
+ * The frames are never decoded, so any remote works, and the receive and send
+ * interrupts do all of it; loop() is free for other work.
+ * While it sends, the receiver is muted [IR_ECHO_MUTE] so it does not repeat
+ * itself; A frame that arrives then is lost.
+ * Needs IR_SEND_ASYNC [set it to 1 in IRremoteInt.h] and IR_FULL_DUPLEX [the
+ * default], on a board that uses Timer2 [an Uno].
+ */
+
+#include <IRremote.h>
+
+#if !IR_SEND_ASYNC
+#  error "IRrepeater needs IR_SEND_ASYNC : Set it to 1 in IRremoteInt.h"
+#endif
+
+int RECV_PIN = 11;
+
+IRrecv irrecv(RECV_PIN);
+
+decode_results results;
+
+unsigned int dropped = 0;
+
+void setup()
+{
+  Serial.begin(9600);
+  irrecv.enableIRIn(); // Start the receiver
+  irrecv.relay(38);    // And send what it hears at 38kHz
+}
+
+void loop() {
+  // Only needed in edge mode [IR_RECV_EDGE], where it closes each frame
+  irrecv.capture(&results);
+
+  if (irrecv.dropped() != dropped) {
+    dropped = irrecv.dropped();
+    Serial.print("Dropped: ");
+    Serial.println(dropped);
+  }
+}
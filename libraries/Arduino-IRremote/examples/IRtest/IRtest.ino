@@ -46,10 +46,10 @@ void dump(decode_results *results) {
 
   for (int i = 0; i < count; i++) {
     if ((i % 2) == 1) {
-      Serial.print(results->rawbuf[i]*USECPERTICK, DEC);
+      Serial.print(results->rawAt(i)*USECPERTICK, DEC);
     } 
     else {
-      Serial.print(-(int)results->rawbuf[i]*USECPERTICK, DEC);
+      Serial.print(-(int)results->rawAt(i)*USECPERTICK, DEC);
     }
     Serial.print(" ");
   }
@@ -81,46 +81,49 @@ public:
     sendlog[sendlogcnt] = -time;
     if (sendlogcnt < SENDLOG_LEN) sendlogcnt++;
   }
-  // Copies the dummy buf into the interrupt buf
-  void useDummyBuf() {
+  // Turns the dummy log in to durations, as the receiver would see them
+  // Returns their number
+  int useDummyBuf(irraw_t *buf) {
     int last = SPACE;
-    irparams.rcvstate = STATE_STOP;
-    irparams.rawlen = 1; // Skip the gap
+    int len = 1;
+    buf[0] = 1000; // The gap before it [50mS]
     for (int i = 0 ; i < sendlogcnt; i++) {
       if (sendlog[i] < 0) {
         if (last == MARK) {
           // New space
-          irparams.rawbuf[irparams.rawlen++] = (-sendlog[i] - MARK_EXCESS) / USECPERTICK;
+          buf[len++] = (-sendlog[i] - MARK_EXCESS) / USECPERTICK;
           last = SPACE;
         } 
         else {
           // More space
-          irparams.rawbuf[irparams.rawlen - 1] += -sendlog[i] / USECPERTICK;
+          buf[len - 1] += -sendlog[i] / USECPERTICK;
         }
       } 
       else if (sendlog[i] > 0) {
         if (last == SPACE) {
           // New mark
-          irparams.rawbuf[irparams.rawlen++] = (sendlog[i] + MARK_EXCESS) / USECPERTICK;
+          buf[len++] = (sendlog[i] + MARK_EXCESS) / USECPERTICK;
           last = MARK;
         } 
         else {
           // More mark
-          irparams.rawbuf[irparams.rawlen - 1] += sendlog[i] / USECPERTICK;
+          buf[len - 1] += sendlog[i] / USECPERTICK;
         }
       }
     }
-    if (irparams.rawlen % 2) {
-      irparams.rawlen--; // Remove trailing space
+    if (len % 2) {
+      len--; // Remove trailing space
     }
+    return len;
   }
 };
 
 IRsendDummy irsenddummy;
 
 void verify(unsigned long val, int bits, int type) {
-  irsenddummy.useDummyBuf();
-  irrecv.decode(&results);
+  static irraw_t buf[RAWBUF];
+  int len = irsenddummy.useDummyBuf(buf);
+  irrecv.decodeSpan(&results, buf, len); // Straight from buf; The receiver is not involved
   Serial.print("Testing ");
   Serial.print(val, HEX);
   if (results.value == val && results.bits == bits && results.decode_type == type) {
@@ -106,10 +106,10 @@ void dump(decode_results *results) {
 
   for (int i = 0; i < count; i++) {
     if ((i % 2) == 1) {
-      Serial.print(results->rawbuf[i]*USECPERTICK, DEC);
+      Serial.print(results->rawAt(i)*USECPERTICK, DEC);
     } 
     else {
-      Serial.print(-(int)results->rawbuf[i]*USECPERTICK, DEC);
+      Serial.print(-(int)results->rawAt(i)*USECPERTICK, DEC);
     }
     Serial.print(" ");
   }
@@ -203,7 +203,7 @@ void testRaw(const char *label, unsigned int *rawbuf, int rawlen) {
       return;
     }
     for (int i = 0; i < rawlen; i++) {
-      long got = results.rawbuf[i+1] * USECPERTICK;
+      long got = results.rawAt(i+1) * USECPERTICK;
       // Adjust for extra duration of marks
       if (i % 2 == 0) { 
         got -= MARK_EXCESS;
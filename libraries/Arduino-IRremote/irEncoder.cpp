@@ -0,0 +1,172 @@
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+//+=============================================================================
+// Send any protocol described by an irencoding_t, one duration at a time
+//
+// Layout of a frame, as pieces that are each a MARK or a SPACE:
+//   hdr[0] hdr[1] hdr[2] hdr[3]  bit halves  stop[0] stop[1]  [gap]
+// and, when rpt is set, a repeat is:
+//   hdr[0] rpt stop[0] stop[1]  [gap]
+//
+// next() adds up pieces until one changes level, and holds on to that one for
+// the next duration.  So Manchester halves, and a stop SPACE with the gap after
+// it, come out as one duration each; A piece of 0 is left out.
+//
+#define STEP_HDR    0  // To 3
+#define STEP_BITS   4
+#define STEP_STOP   5  // And 6
+#define STEP_GAP    7
+#define STEP_END    8
+
+//+=============================================================================
+void  IRbitEncoder::begin (const irencoding_t *enc_P,  unsigned long data,  uint8_t nbits,  uint8_t frames)
+{
+	begin(enc_P, 0, 0, data, nbits, frames);
+}
+
+void  IRbitEncoder::begin (const irencoding_t *enc_P,  unsigned long address,  uint8_t abits,
+                           unsigned long data,  uint8_t nbits,  uint8_t frames)
+{
+	this->enc     = enc_P;
+	this->khz     = pgm_read_byte(&enc_P->khz);
+	this->address = address;
+	this->abits   = abits;
+	this->data    = data;
+	this->nbits   = nbits;
+	this->frames  = frames ? frames : 1;
+	this->repeat  = !frames;
+
+	step    = STEP_HDR;
+	half    = 0;
+	held    = 0;
+	elapsed = 0;
+	level   = MARK;
+}
+
+//+=============================================================================
+// The next piece of the frame : Its level, and length in uS [0 = None]
+// false once the last frame is done
+//
+bool  IRbitEncoder::piece (uint8_t *lvl,  unsigned long *usec)
+{
+	uint8_t  s = step++;
+
+	switch (s) {
+		case STEP_HDR + 0:
+		case STEP_HDR + 1:
+		case STEP_HDR + 2:
+		case STEP_HDR + 3:
+			*lvl  = (s & 1) ? SPACE : MARK;
+			*usec = pgm_read_word(&enc->hdr[s - STEP_HDR]);
+			if (repeat) {
+				unsigned int  rpt = pgm_read_word(&enc->rpt);
+				if (rpt) {
+					if (s == STEP_HDR + 1) {
+						*usec = rpt;
+						step  = STEP_STOP;
+					}
+				} else if (pgm_read_byte(&enc->flags) & IR_ENC_RPT_NOHDR) {
+					*usec = 0;
+					step  = STEP_BITS;
+				}
+			}
+			break;
+
+		case STEP_BITS: {
+			uint8_t  start = pgm_read_byte(&enc->start);
+			uint8_t  b     = half >> 1;
+			uint8_t  sh;
+			bool     one;
+
+			if (b >= start + abits + nbits) {
+				*usec = 0;  // On to the stop
+				break;
+			}
+			step = STEP_BITS;
+
+			if (b < start) {
+				one = true;
+			} else if ((b -= start) < abits) {
+				one = (address >> (abits - 1 - b)) & 1;
+			} else {
+				sh  = nbits - 1 - (b - abits);
+				one = (sh < 32) && ((data >> sh) & 1);  // Bits above 32 are 0
+			}
+
+			*lvl  = (pgm_read_byte(&enc->flags) & (one ? IR_ENC_ONE_SPACE : IR_ENC_ZERO_SPACE)) ? SPACE : MARK;
+			*lvl ^= half & 1;
+			*usec = pgm_read_word(one ? &enc->one[half & 1] : &enc->zero[half & 1]);
+			if ((half >> 1) && ((half >> 1) == pgm_read_byte(&enc->wide)))  *usec *= 2 ;
+			half++;
+			break;
+		}
+
+		case STEP_STOP + 0:
+			*lvl  = MARK;
+			*usec = pgm_read_word(&enc->stop[0]);
+			break;
+
+		case STEP_STOP + 1:
+			*lvl  = SPACE;
+			*usec = pgm_read_word(&enc->stop[1]);
+			break;
+
+		case STEP_GAP: {
+			unsigned long  period = pgm_read_dword(&enc->period);
+
+			if (frames <= 1)  break ;
+
+			// Up to the start of the next frame : A repeat
+			*lvl  = SPACE;
+			*usec = (period > elapsed) ? (period - elapsed) : 0;
+			if (!*usec && !pgm_read_word(&enc->stop[1]))  *usec = _GAP ;
+
+			frames--;
+			repeat  = true;
+			data   ^= pgm_read_word(&enc->toggle);
+			step    = STEP_HDR;
+			half    = 0;
+			elapsed = 0;
+			return true;
+		}
+
+		default:
+			break;
+	}
+
+	if (s >= STEP_GAP) {
+		step = STEP_END;
+		return false;
+	}
+
+	elapsed += *usec;
+	return true;
+}
+
+//+=============================================================================
+// The next MARK or SPACE [they take turns, starting with a MARK]
+//
+bool  IRbitEncoder::next (unsigned long *usec)
+{
+	uint8_t        lvl;
+	unsigned long  us;
+
+	*usec = held;
+	held  = 0;
+	while (piece(&lvl, &us)) {
+		if (!us)  continue ;
+
+		if (lvl == level) {
+			*usec += us;
+		} else if (*usec) {
+			// Keep it for the next call
+			held  = us;
+			level = lvl;
+			return true;
+		}
+		// else : A SPACE before the first MARK
+	}
+
+	return *usec != 0;
+}
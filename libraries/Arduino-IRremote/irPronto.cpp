@@ -1,4 +1,24 @@
+//******************************************************************************
+// Pronto codes
+// Sources:
+//   http://www.remotecentral.com/features/irdisp2.htm
+//   http://www.hifi-remote.com/wiki/index.php?title=Working_With_Pronto_Hex
+//
+// sendPronto() parses the hex string each time it sends it.
+// sendPronto_P() sends a code compiled ahead of time in to PROGMEM :
+//   { carrier kHz, "once" pairs, "repeat" pairs, the durations in uS ... }
+// which is a third of the flash of the string, and needs no parsing and no
+// floating point to send.
+//
+// Compile codes on the host with this file [the same arithmetic as sendPronto()]
+//   g++ -DTEST=1 -x c++ irPronto.cpp -o pronto
+//   ./pronto buttonName "0000 006D 0022 0002 ..."  : Prints the PROGMEM record
+//   ./pronto                                       : Checks that sendPronto_P()
+//                                                    sends what sendPronto() does
+//******************************************************************************
+#ifndef TEST
 #define TEST 0
+#endif
 
 #if TEST
 #	define SEND_PRONTO        1
@@ -6,24 +26,40 @@
 #	define PRONTO_REPEAT      true
 #	define PRONTO_FALLBACK    true
 #	define PRONTO_NOFALLBACK  false
-#endif
+#else
+#	include "IRremote.h"
+#endif // TEST
 
 #if SEND_PRONTO
 
 //******************************************************************************
 #if TEST
 #	include <stdio.h>
-	void  enableIROut (int freq)  { printf("\nFreq = %d KHz\n", freq); }
-	void  mark        (int t)     { printf("+%d," , t); }
-	void  space       (int t)     { printf("-%d, ", t); }
-#else
-#	include "IRremote.h"
+#	include <stdint.h>
+#	include <string.h>
+#	define PROGMEM
+#	define pgm_read_word(p)  (*(const unsigned int *)(p))
+
+	// Stand-in for IRsend : Logs the waveform [+mark -space], and prints it if asked
+	unsigned long  wave[512];
+	int            waveLen;
+	bool           wavePrint;
+
+	class IRsend
+	{
+		public:
+			void  enableIROut  (int khz)            { waveLen = 0;  wave[waveLen++] = khz;  if (wavePrint)  printf("\nFreq = %d KHz\n", khz) ; }
+			void  mark         (unsigned int usec)  { wave[waveLen++] = usec;  if (wavePrint)  printf("+%u,", usec) ; }
+			void  space        (unsigned int usec)  { wave[waveLen++] = usec;  if (wavePrint)  printf("-%u, ", usec) ; }
+			bool  sendPronto   (char* code,  bool repeat,  bool fallback) ;
+			void  sendPronto_P (const unsigned int *code_P,  bool repeat,  bool fallback) ;
+	};
 #endif // TEST
 
 //+=============================================================================
 // Check for a valid hex digit
 //
-bool  ishex (char ch)
+static bool  ishex (char ch)
 {
 	return ( ((ch >= '0') && (ch <= '9')) ||
              ((ch >= 'A') && (ch <= 'F')) ||
@@ -33,7 +69,7 @@ bool  ishex (char ch)
 //+=============================================================================
 // Check for a valid "blank" ... '\0' is a valid "blank"
 //
-bool  isblank (char ch)
+static bool  isblank (char ch)
 {
 	return ((ch == ' ') || (ch == '\t') || (ch == '\0')) ? true : false ;
 }
@@ -41,20 +77,21 @@ bool  isblank (char ch)
 //+=============================================================================
 // Bypass spaces
 //
-bool  byp (char** pcp)
+static void  byp (char** pcp)
 {
-	while (isblank(**pcp))  (*pcp)++ ;
+	while (**pcp && isblank(**pcp))  (*pcp)++ ;
 }
 
 //+=============================================================================
 // Hex-to-Byte : Decode a hex digit
 // We assume the character has already been validated
 //
-uint8_t  htob (char ch)
+static uint8_t  htob (char ch)
 {
 	if ((ch >= '0') && (ch <= '9'))  return ch - '0' ;
 	if ((ch >= 'A') && (ch <= 'F'))  return ch - 'A' + 10 ;
 	if ((ch >= 'a') && (ch <= 'f'))  return ch - 'a' + 10 ;
+	return 0;
 }
 
 //+=============================================================================
@@ -62,15 +99,31 @@ uint8_t  htob (char ch)
 // We assume the string has already been validated
 //   and the pointer being passed points at the start of a block of 4 hex digits
 //
-uint16_t  htow (char* cp)
+static uint16_t  htow (char* cp)
 {
 	return ( (htob(cp[0]) << 12) | (htob(cp[1]) <<  8) |
              (htob(cp[2]) <<  4) | (htob(cp[3])      )  ) ;
 }
 
+//+=============================================================================
+// Which durations to send, of 'once' pairs followed by 'rpt' pairs
+// Returns how many, and sets skip to the first of them
+//
+static int  prontoSection (uint8_t once,  uint8_t rpt,  bool repeat,  bool fallback,  int *skip)
+{
+	// Fallback on the "other" code if "this" code is not present
+	if (fallback) {
+		if (!repeat && !once)  repeat = true ;
+		if ( repeat && !rpt )  repeat = false ;
+	}
+
+	*skip = repeat ? (once * 2) : 0;  // 'repeat' starts where 'once' ends
+	return  repeat ? (rpt  * 2) : (once * 2);
+}
+
 //+=============================================================================
 //
-bool sendPronto (char* s,  bool repeat,  bool fallback)
+bool  IRsend::sendPronto (char* s,  bool repeat,  bool fallback)
 {
 	int       i;
 	int       len;
@@ -84,6 +137,7 @@ bool sendPronto (char* s,  bool repeat,  bool fallback)
 	// Validate the string
 	for (cp = s;  *cp;  cp += 4) {
 		byp(&cp);
+		if (!*cp)  break ;
 		if ( !ishex(cp[0]) || !ishex(cp[1]) ||
 		     !ishex(cp[2]) || !ishex(cp[3]) || !isblank(cp[4]) )  return false ;
 	}
@@ -114,18 +168,7 @@ bool sendPronto (char* s,  bool repeat,  bool fallback)
 	cp += 4;
 
 	// Which code are we sending?
-	if (fallback) { // fallback on the "other" code if "this" code is not present
-		if (!repeat) { // requested 'once'
-			if (once)  len = once * 2,  skip = 0 ;  // if once exists send it
-			else       len = rpt  * 2,  skip = 0 ;  // else send repeat code
-		} else { // requested 'repeat'
-			if (rpt)   len = rpt  * 2,  skip = 0 ;  // if rpt exists send it
-			else       len = once * 2,  skip = 0 ;  // else send once code
-		}
-	} else {  // Send what we asked for, do not fallback if the code is empty!
-		if (!repeat)  len = once * 2,  skip = 0 ;     // 'once' starts at 0
-		else          len = rpt  * 2,  skip = once ;  // 'repeat' starts where 'once' ends
-    }
+	len = prontoSection(once, rpt, repeat, fallback, &skip);
 
 	// Skip to start of code
 	for (i = 0;  i < skip;  i++, cp += 4)  byp(&cp) ;
@@ -133,381 +176,178 @@ bool sendPronto (char* s,  bool repeat,  bool fallback)
 	// Send code
 	enableIROut(freq);
 	for (i = 0;  i < len;  i++) {
+		unsigned long  t;
+
 		byp(&cp);
-		if (i & 1)  space(htow(cp) * usec);
-		else        mark (htow(cp) * usec);
+		t = (unsigned long)htow(cp) * usec;
+		if (t > 0xFFFF)  t = 0xFFFF ;  // Only a lead-out gets this long; It just spaces the codes
+		if (i & 1)  space(t);
+		else        mark (t);
 		cp += 4;
 	}
+
+	return true;
 }
 
 //+=============================================================================
-#if TEST
-
-int  main ( )
+// Send a Pronto code compiled in to PROGMEM [see the top of this file]
+// code_P : { kHz, "once" pairs, "repeat" pairs, durations in uS }
+//
+void  IRsend::sendPronto_P (const unsigned int *code_P,  bool repeat,  bool fallback)
 {
-	char  prontoTest[] =
-		"0000 0070 0000 0032 0080 0040 0010 0010 0010 0030 " //  10
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  20
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  30
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  40
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  50
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  60
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  70
-		"0010 0010 0010 0030 0010 0010 0010 0030 0010 0010 " //  80
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " //  90
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " // 100
-		"0010 0030 0010 0aa6";                               // 104
-
-	sendPronto(prontoTest, PRONTO_ONCE,   PRONTO_FALLBACK);    // once code
-	sendPronto(prontoTest, PRONTO_REPEAT, PRONTO_FALLBACK);    // repeat code
-	sendPronto(prontoTest, PRONTO_ONCE,   PRONTO_NOFALLBACK);  // once code
-	sendPronto(prontoTest, PRONTO_REPEAT, PRONTO_NOFALLBACK);  // repeat code
-
-	return 0;
-}
-
-#endif // TEST
-
-#endif // SEND_PRONTO
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+	int  len;
+	int  skip;
 
+	len = prontoSection(pgm_read_word(&code_P[1]), pgm_read_word(&code_P[2]), repeat, fallback, &skip);
 
+	enableIROut(pgm_read_word(&code_P[0]));
+	for (int i = 0;  i < len;  i++) {
+		unsigned int  t = pgm_read_word(&code_P[3 + skip + i]);
 
-
-
-
-
-
-
-#if 0
-//******************************************************************************
-// Sources:
-//   http://www.remotecentral.com/features/irdisp2.htm
-//   http://www.hifi-remote.com/wiki/index.php?title=Working_With_Pronto_Hex
-//******************************************************************************
-
-#include <stdint.h>
-#include <stdio.h>
-
-#define IRPRONTO
-#include "IRremoteInt.h"  // The Arduino IRremote library defines USECPERTICK
-
-//------------------------------------------------------------------------------
-// Source: https://www.google.co.uk/search?q=DENON+MASTER+IR+Hex+Command+Sheet
-//         -> http://assets.denon.com/documentmaster/us/denon%20master%20ir%20hex.xls
-//
-char  prontoTest[] =
-	"0000 0070 0000 0032 0080 0040 0010 0010 0010 0030 " //  10
-	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  20
-	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  30
-	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  40
-	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  50
-	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  60
-	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  70
-	"0010 0010 0010 0030 0010 0010 0010 0030 0010 0010 " //  80
-	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " //  90
-	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " // 100
-	"0010 0030 0010 0aa6";                               // 104
-
-//------------------------------------------------------------------------------
-// This is the longest code we can support
-#define CODEMAX  200
-
-//------------------------------------------------------------------------------
-// This is the data we pull out of the pronto code
-typedef
-	struct {
-		int        freq;           // Carrier frequency (in Hz)
-		int        usec;           // uSec per tick (based on freq)
-
-		int        codeLen;        // Length of code
-		uint16_t   code[CODEMAX];  // Code in hex
-
-		int        onceLen;        // Length of "once" transmit
-		uint16_t*  once;           // Pointer to start within 'code'
-
-		int        rptLen;         // Length of "repeat" transmit
-		uint16_t*  rpt;            // Pointer to start within 'code'
+		if (i & 1)  space(t);
+		else        mark (t);
 	}
-pronto_t;
-
-//------------------------------------------------------------------------------
-// From what I have seen, the only time we go over 8-bits is the 'space'
-// on the end which creates the lead-out/inter-code gap.  Assuming I'm right,
-// we can code this up as a special case and otherwise halve the size of our
-// data!
-// Ignoring the first four values (the config data) and the last value
-// (the lead-out), if you find a protocol that uses values greater than 00fe
-// we are going to have to revisit this code!
-//
-//
-// So, the 0th byte will be the carrier frequency in Khz (NOT Hz)
-//      "  1st  "    "   "   "  length of the "once" code
-//      "  2nd  "    "   "   "  length of the "repeat" code
-//
-// Thereafter, odd  bytes will be Mark  lengths as a multiple of USECPERTICK uS
-//             even   "     "  "  Space    "    "  "    "     "       "      "
-//
-// Any occurence of "FF" in either a Mark or a Space will indicate
-//   "Use the 16-bit FF value" which will also be a multiple of USECPERTICK uS
-//
-//
-// As a point of comparison, the test code (prontoTest[]) is 520 bytes
-// (yes, more than 0.5KB of our Arduino's precious 32KB) ... after conversion
-// to pronto hex that goes down to ((520/5)*2) = 208 bytes ... once converted to
-// our format we are down to ((208/2) -1 -1 +2) = 104 bytes
-//
-// In fariness this is still very memory-hungry
-// ...As a rough guide:
-//   10 codes cost 1K of memory (this will vary depending on the protocol).
-//
-// So if you're building a complex remote control, you will probably need to
-// keep the codes on an external memory device (not in the Arduino sketch) and
-// load them as you need them.  Hmmm.
-//
-// This dictates that "Oscillated Pronto Codes" are probably NOT the way forward
-//
-// For example, prontoTest[] happens to be: A 48-bit IR code in Denon format
-// So we know it starts with 80/40                           (Denon header)
-//             and ends with 10/aa6                          (Denon leadout)
-//             and all (48) bits in between are either 10/10 (Denon 0)
-//                                                  or 10/30 (Denon 1)
-// So we could easily store this data in 1-byte  ("Denon")
-//                                     + 1-byte  (Length=48)
-//                                     + 6-bytes (IR code)
-// At 8-bytes per code, we can store 128 codes in 1KB or memory - that's a lot
-// better than the 2 (two) we started off with!
-//
-// And serendipitously, by reducing the amount of data, our program will run
-// a LOT faster!
-//
-// Again, I repeat, even after you have spent time converting the "Oscillated
-// Pronto Codes" in to IRremote format, it will be a LOT more memory-hungry
-// than using sendDenon() (or whichever) ...BUT these codes are easily
-// available on the internet, so we'll support them!
-//
-typedef
-	struct {
-		uint16_t   FF;
-		uint8_t    code[CODEMAX];
-	}
-irCode_t;
-
-//------------------------------------------------------------------------------
-#define DEBUGF(...)  printf(__VA_ARGS__)
+}
 
+#if IR_SEND_ASYNC
 //+=============================================================================
-// String must be block of 4 hex digits separated with blanks
+// The same, but queued [see IRsend::sendRawAsync()]
 //
-bool  validate (char* cp,  int* len)
+int  IRsend::sendProntoAsync_P (const unsigned int *code_P,  bool repeat,  bool fallback)
 {
-	for (*len = 0;  *cp;  (*len)++, cp += 4) {
-		byp(&cp);
-		if ( !ishex(cp[0]) || !ishex(cp[1]) ||
-		     !ishex(cp[2]) || !ishex(cp[3]) || !isblank(cp[4]) )  return false ;
-	}
+	int  len;
+	int  skip;
 
-	return true;
-}
+	len = prontoSection(pgm_read_word(&code_P[1]), pgm_read_word(&code_P[2]), repeat, fallback, &skip);
 
-//+=============================================================================
-// Hex-to-Byte : Decode a hex digit
-// We assume the character has already been validated
-//
-uint8_t  htob (char ch)
-{
-	if ((ch >= '0') && (ch <= '9'))  return ch - '0' ;
-	if ((ch >= 'A') && (ch <= 'F'))  return ch - 'A' + 10 ;
-	if ((ch >= 'a') && (ch <= 'f'))  return ch - 'a' + 10 ;
+	return sendRawAsync_P(&code_P[3 + skip], len, pgm_read_word(&code_P[0]));
 }
+#endif
 
 //+=============================================================================
-// Hex-to-Word : Decode a block of 4 hex digits
-// We assume the string has already been validated
-//   and the pointer being passed points at the start of a block of 4 hex digits
-//
-uint16_t  htow (char* cp)
-{
-	return ( (htob(cp[0]) << 12) | (htob(cp[1]) <<  8) |
-             (htob(cp[2]) <<  4) | (htob(cp[3])      )  ) ;
-}
+#if TEST
 
 //+=============================================================================
-// Convert the pronto string in to data
+// Compile a Pronto string in to a sendPronto_P() record
+// Returns its length, or 0 if the string is not a Pronto code we can send
 //
-bool  decode (char* s,  pronto_t* p,  irCode_t* ir)
+static int  prontoCompile (char* s,  unsigned int *out,  int max)
 {
-	int    i, len;
-	char*  cp;
-
-	// Validate the Pronto string
-	if (!validate(s, &p->codeLen)) {
-		DEBUGF("Invalid pronto string\n");
-		return false ;
-    }
-	DEBUGF("Found %d hex codes\n", p->codeLen);
-
-	// Allocate memory to store the decoded string
-	//if (!(p->code = malloc(p->len))) {
-	//	DEBUGF("Memory allocation failed\n");
-	//	return false ;
-	//}
-
-	// Check in case our code is too long
-	if (p->codeLen > CODEMAX) {
-		DEBUGF("Code too long, edit CODEMAX and recompile\n");
-		return false ;
-	}
+	uint16_t  code[256];
+	int       n = 0;
+	uint16_t  freq;
+	uint8_t   usec;
+	char*     cp;
 
-	// Decode the string
-	cp = s;
-	for (i = 0;  i < p->codeLen;  i++, cp += 4) {
+	for (cp = s;  *cp;  cp += 4) {
 		byp(&cp);
-		p->code[i] = htow(cp);
+		if (!*cp)  break ;
+		if ( !ishex(cp[0]) || !ishex(cp[1]) ||
+		     !ishex(cp[2]) || !ishex(cp[3]) || !isblank(cp[4]) || (n >= 256) )  return 0 ;
+		code[n++] = htow(cp);
 	}
 
-	// Announce our findings
-	DEBUGF("Input: |%s|\n", s);
-	DEBUGF("Found: |");
-    for (i = 0;  i < p->codeLen;  i++)  DEBUGF("%04x ", p->code[i]) ;
-	DEBUGF("|\n");
-
-	DEBUGF("Form [%04X] : ", p->code[0]);
-	if      (p->code[0] == 0x0000)  DEBUGF("Oscillated (Learned)\n");
-	else if (p->code[0] == 0x0100)  DEBUGF("Unmodulated\n");
-	else                            DEBUGF("Unknown\n");
-    if (p->code[0] != 0x0000)  return false ;  // Can only handle Oscillated
-
-	// Calculate the carrier frequency (+/- 10%) & uSecs per pulse
-	// Pronto uses a crystal which generates a timeabse of 0.241246
-	p->freq     = (int)(1000000 / (p->code[1] * 0.241246));
-	p->usec     = (int)(((1.0 / p->freq) * 1000000) + 0.5);
-	ir->code[0] = p->freq / 1000;
-    DEBUGF("Freq [%04X] : %d Hz  (%d uS/pluse) -> %d KHz\n",
-	       p->code[1], p->freq, p->usec, ir->code[0]);
-
-	// Set the length & start pointer for the "once" code
-	p->onceLen  = p->code[2];
-	p->once     = &p->code[4];
-	ir->code[1] = p->onceLen;
-	DEBUGF("Once [%04X] : %d\n", p->code[2], p->onceLen);
-
-	// Set the length & start pointer for the "repeat" code
-	p->rptLen = p->code[3];
-	p->rpt    = &p->code[4 + p->onceLen];
-	ir->code[2] = p->rptLen;
-	DEBUGF("Rpt  [%04X] : %d\n", p->code[3], p->rptLen);
-
-	// Check everything tallies
-	if (1 + 1 + 1 + 1 + (p->onceLen * 2) + (p->rptLen * 2) != p->codeLen) {
-		DEBUGF("Bad code length\n");
-		return false;
+	// Oscillated, with the lengths it claims
+	if ((n < 4) || (code[0] != 0x0000))                       return 0 ;
+	if ((code[2] > 255) || (code[3] > 255))                   return 0 ;
+	if (n != 4 + (code[2] * 2) + (code[3] * 2))               return 0 ;
+	if (3 + (code[2] * 2) + (code[3] * 2) > max)              return 0 ;
+
+	// The same arithmetic as sendPronto()
+	freq = (int)(1000000 / (code[1] * 0.241246));
+	usec = (int)(((1.0 / freq) * 1000000) + 0.5);
+	freq /= 1000;
+
+	out[0] = freq;
+	out[1] = code[2];
+	out[2] = code[3];
+	for (int i = 4;  i < n;  i++) {
+		unsigned long  t = (unsigned long)code[i] * usec;
+		out[i - 1] = (t > 0xFFFF) ? 0xFFFF : t;
 	}
 
-	// Convert the IR data to our new format
-	ir->FF = p->code[p->codeLen - 1];
-
-	len = (p->onceLen * 2) + (p->rptLen * 2);
-	DEBUGF("Encoded: |");
-	for (i = 0;  i < len;  i++) {
-		if (p->code[i+4] == ir->FF) {
-			ir->code[i+3] = 0xFF;
-		} else if (p->code[i+4] > 0xFE) {
-			DEBUGF("\n%04X : Mark/Space overflow\n", p->code[i+4]);
-			return false;
-		} else {
-			ir->code[i+3] = (p->code[i+4] * p->usec) / USECPERTICK;
-		}
-		DEBUGF("%s%d", !i ? "" : (i&1 ? "," : ", "), ir->code[i+3]);
-	}
-	DEBUGF("|\n");
-
-	ir->FF = (ir->FF * p->usec) / USECPERTICK;
-	DEBUGF("FF -> %d\n", ir->FF);
-
-	return true;
+	return n - 1;
 }
 
 //+=============================================================================
+// Send a code both ways, and compare what reached the LED
 //
-void  irDump (irCode_t* ir)
+static bool  prontoCheck (IRsend *irsend,  char* s,  bool repeat,  bool fallback)
 {
-	int  i, len;
-
-	printf("uint8_t  buttonName[%d] = {", len);
+	unsigned int   record[512];
+	unsigned long  parsed[512];
+	int            parsedLen;
 
-	printf("%d,%d, ", (ir->FF >> 8), ir->FF & 0xFF);
-	printf("%d,%d,%d, ", ir->code[0], ir->code[1], ir->code[2]);
+	if (!prontoCompile(s, record, 512))  return false ;
 
-	len = (ir->code[1] * 2) + (ir->code[2] * 2);
-	for (i = 0;  i < len;  i++) {
-		printf("%s%d", !i ? "" : (i&1 ? "," : ", "), ir->code[i+3]);
-	}
+	irsend->sendPronto(s, repeat, fallback);
+	memcpy(parsed, wave, sizeof(wave));
+	parsedLen = waveLen;
 
-	printf("};\n");
+	irsend->sendPronto_P(record, repeat, fallback);
 
+	return (parsedLen == waveLen) && !memcmp(parsed, wave, waveLen * sizeof(wave[0]));
 }
 
-//+=============================================================================
-//
-int  main ( )
+int  main (int argc,  char* argv[])
 {
-	pronto_t  pCode;
-	irCode_t  irCode;
+	IRsend  irsend;
 
-	decode(prontoTest, &pCode, &irCode);
+	// Compile a code
+	if (argc == 3) {
+		unsigned int  record[512];
+		int           len = prontoCompile(argv[2], record, 512);
 
-	irDump(&irCode);
+		if (!len) {
+			fprintf(stderr, "Not a Pronto code that can be sent\n");
+			return 1;
+		}
+		printf("const unsigned int  %s[%d] PROGMEM = {%u,%u,%u, ", argv[1], len, record[0], record[1], record[2]);
+		for (int i = 3;  i < len;  i++)  printf("%u%s", record[i], (i + 1 == len) ? "" : ((i & 1) ? "," : ", ")) ;
+		printf("};  // Pronto %s\n", argv[2]);
+		return 0;
+	}
 
-	return 0;
+	// Source: https://www.google.co.uk/search?q=DENON+MASTER+IR+Hex+Command+Sheet
+	//         -> http://assets.denon.com/documentmaster/us/denon%20master%20ir%20hex.xls
+	char  prontoTest[] =
+		"0000 0070 0000 0032 0080 0040 0010 0010 0010 0030 " //  10
+		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  20
+		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  30
+		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  40
+		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  50
+		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  60
+		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  70
+		"0010 0010 0010 0030 0010 0010 0010 0030 0010 0010 " //  80
+		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " //  90
+		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " // 100
+		"0010 0030 0010 0aa6";                               // 104
+
+	// Both a "once" and a "repeat" code [NEC header and lead-out, then its repeat]
+	char  prontoBoth[] =
+		"0000 006D 0002 0002 0156 00AB 0015 05E7 0156 0055 0015 0E47";
+
+	char  *tests[] = { prontoTest, prontoBoth };
+	int   failed   = 0;
+
+	for (int t = 0;  t < 2;  t++) {
+		for (int mode = 0;  mode < 4;  mode++) {
+			bool  repeat   = mode & 1;
+			bool  fallback = mode & 2;
+			bool  ok       = prontoCheck(&irsend, tests[t], repeat, fallback);
+
+			printf("Code %d, %s, %s : %s\n", t, repeat ? "repeat" : "once", fallback ? "fallback" : "no fallback", ok ? "OK" : "DIFFERENT");
+			if (!ok)  failed++ ;
+		}
+	}
+
+	wavePrint = true;
+	irsend.sendPronto(prontoTest, PRONTO_ONCE, PRONTO_FALLBACK);
+	printf("\n");
+
+	return failed ? 1 : 0;
 }
 
-#endif //0
+#endif // TEST
+
+#endif // SEND_PRONTO
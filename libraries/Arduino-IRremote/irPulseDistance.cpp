@@ -0,0 +1,168 @@
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+//+=============================================================================
+// Decode any protocol described by an irpulse_t
+// proto_P : The description, in PROGMEM
+// offset  : Index of the header mark [1 skips the gap]
+//
+// Layout of a frame [after 'offset']:
+//   [hdrMark] [hdrSpace] bit * bits [bitFixed MARK if IR_PD_STOP]
+// and, when rptSpace is set, a REPEAT is:
+//   hdrMark rptSpace bitFixed
+//
+// More than 32 bits: value holds the last 32, address the ones before them;
+// data has them all [IR_RESULT_BITS], in the order received.
+//
+bool  IRrecv::decodePulseDistance (decode_results *results,  const irpulse_t *proto_P,  int offset)
+{
+	irpulse_t      p;
+	unsigned long  data  = 0;  // We decode in to here; Start with nothing
+	unsigned int   high  = 0;  // Bits shifted out of the top of data
+	int            nbits = 0;
+	int            len;
+	bool           one;
+
+	memcpy_P(&p, proto_P, sizeof(p));
+
+	// A frame of bits without its header is a repeat
+	if ( (p.flags & IR_PD_RPT_NOHDR)
+	    && (results->rawlen == offset + (2 * p.bits) + 1)
+	    && MATCH_TICKS(results->rawAt(offset), p.bitFixed)
+	    && MATCH_TICKS(results->rawAt(results->rawlen - 1), p.bitFixed)
+	   ) {
+		goto repeat;
+	}
+
+	// Header "mark"
+	if (p.hdrMark.hi) {
+		if (!MATCH_TICKS(results->rawAt(offset), p.hdrMark))  return false ;
+		offset++;
+	}
+
+	// Short repeat frame
+	if ( p.rptSpace.hi
+	    && (results->rawlen == offset + 2)
+	    && MATCH_TICKS(results->rawAt(offset  ), p.rptSpace)
+	    && MATCH_TICKS(results->rawAt(offset+1), p.bitFixed)
+	   ) {
+		goto repeat;
+	}
+
+	// Check we have enough data
+	len = offset + (p.hdrSpace.hi ? 1 : 0) + (2 * p.bits);
+	if (!(p.flags & IR_PD_PULSE_WIDTH))  len++ ;  // The last bit's SPACE ends with a MARK
+	if (p.flags & IR_PD_EXACT) {
+		if (results->rawlen != len)  return false ;
+	} else {
+		if (results->rawlen <  len)  return false ;
+	}
+
+	// Header "space"
+	if (p.hdrSpace.hi) {
+		if (!MATCH_TICKS(results->rawAt(offset), p.hdrSpace))  return false ;
+		offset++;
+	}
+
+	// Build the data
+	if (p.flags & IR_PD_PULSE_WIDTH) {
+		// SPACE + MARK; The bit count is however many fit before the gap
+		while ((offset + 1 < results->rawlen) && (nbits < 32)) {
+			if (!MATCH_TICKS(results->rawAt(offset), p.bitFixed))  break ;
+			offset++;
+			if      (MATCH_TICKS(results->rawAt(offset), p.bitOne ))  one = true ;
+			else if (MATCH_TICKS(results->rawAt(offset), p.bitZero))  one = false ;
+			else                                                       return false ;
+			data = (data << 1) | one;
+			IR_RESULT_APPEND(results, one);
+			offset++;
+			nbits++;
+		}
+		if (nbits < p.bits)  return false ;
+
+	} else {
+		// MARK + SPACE
+		for (;  nbits < p.bits;  nbits++) {
+			if (!MATCH_TICKS(results->rawAt(offset), p.bitFixed))  return false ;
+			offset++;
+			if      (MATCH_TICKS(results->rawAt(offset), p.bitOne ))  one = true ;
+			else if (MATCH_TICKS(results->rawAt(offset), p.bitZero))  one = false ;
+			else                                                       return false ;
+			high = (high << 1) | (data >> 31);
+			data = (data << 1) | one;
+			IR_RESULT_APPEND(results, one);
+			offset++;
+		}
+
+		// Stop bit
+		if ((p.flags & IR_PD_STOP) && !MATCH_TICKS(results->rawAt(offset), p.bitFixed))  return false ;
+	}
+
+	// Bits arrived least significant first; Turn them round [up to 32 bits]
+	if (p.flags & IR_PD_LSB_FIRST) {
+		unsigned long  rev = 0;
+		for (int i = 0;  i < nbits;  i++, data >>= 1)  rev = (rev << 1) | (data & 1) ;
+		data = rev;
+	}
+
+	// Success
+	if (nbits > 32)  results->address = high ;
+	results->bits        = nbits;
+	results->value       = data;
+	results->decode_type = (decode_type_t)p.type;
+	return true;
+
+repeat:
+	results->bits        = 0;
+	results->value       = REPEAT;
+	results->decode_type = (decode_type_t)p.type;
+	return true;
+}
+
+#if IR_RECV_STREAM
+//+=============================================================================
+// Report a frame that the ISR has already decoded [see streamTicks()]
+// It checked every duration against the protocol locked then, kept in the
+// slot, as it arrived, so all that is left is to put the bits the right way
+// round.  lockProtocol() may have moved irstream on to another one since.
+//
+bool  IRrecv::decodeStreamed (decode_results *results,  volatile irslot_t *slot)
+{
+	const irpulse_t  *proto_P = (const irpulse_t *)slot->streamproto;
+	unsigned long    data     = slot->streamdata;
+	uint8_t          nbits;
+	uint8_t          flags;
+
+	nbits = pgm_read_byte(&proto_P->bits);
+	flags = pgm_read_byte(&proto_P->flags);
+
+	results->decode_type = (decode_type_t)(int8_t)pgm_read_byte(&proto_P->type);
+#if IR_RESULT_BITS
+	results->data.clear();
+#endif
+
+	// A REPEAT is just hdrMark + rptSpace + bitFixed
+	if (slot->rawlen == 4) {
+		results->bits  = 0;
+		results->value = REPEAT;
+		return true;
+	}
+
+#if IR_RESULT_BITS
+	// The ISR shifted them in as they came
+	if (nbits > 32)  results->data.append(slot->streamhigh, nbits - 32) ;
+	results->data.append(data, (nbits > 32) ? 32 : nbits);
+#endif
+
+	if (flags & IR_PD_LSB_FIRST) {
+		unsigned long  rev = 0;
+		for (uint8_t i = 0;  i < nbits;  i++, data >>= 1)  rev = (rev << 1) | (data & 1) ;
+		data = rev;
+	}
+
+	if (nbits > 32)  results->address = slot->streamhigh ;
+	results->bits  = nbits;
+	results->value = data;
+	return true;
+}
+#endif
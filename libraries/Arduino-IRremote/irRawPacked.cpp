@@ -0,0 +1,343 @@
+//******************************************************************************
+// Packed raw codes
+//
+// sendRaw() needs its durations in RAM, two bytes each: An air conditioner
+// code of 200+ durations is 400+ bytes.  sendRawPacked_P() sends a code kept
+// in PROGMEM, packed to about a byte a duration or less, unpacking it as it goes.
+//
+// The record is bytes:
+//   carrier kHz, unit uS [low byte, high byte], then
+//   1..127       : A duration of that many units
+//   0x80+hi, lo  : A duration of ((hi << 8) + lo) units [0..32767]
+//   0, n         : The last MARK and SPACE again, n more times [1..255]
+//   0, 0         : End
+// Durations alternate MARK, SPACE ... as for sendRaw().  The unit is chosen
+// per code, so that every duration is a whole number of them, to within 10%.
+//
+// Pack codes on the host with this file
+//   g++ -DTEST=1 -x c++ irRawPacked.cpp -o rawpacked
+//   ./rawpacked buttonName [kHz] < dump.txt  : Prints the PROGMEM record
+//   ./rawpacked                              : Packs and sends some codes, and
+//                                              reports their size and timing
+// dump.txt is what IRrecvDumpV2 prints [the rawData[] line, or the Timing[]
+// block] or the line of m/s durations IRrecord prints.
+//******************************************************************************
+#ifndef TEST
+#define TEST 0
+#endif
+
+#if TEST
+#	define SEND_RAW_PACKED    1
+#else
+#	include "IRremote.h"
+#endif // TEST
+
+#if SEND_RAW_PACKED
+
+//******************************************************************************
+#if TEST
+#	include <stdio.h>
+#	include <stdint.h>
+#	include <stdlib.h>
+#	include <string.h>
+#	include <ctype.h>
+#	define PROGMEM
+#	define pgm_read_byte(p)  (*(const uint8_t *)(p))
+#	define USECPERTICK       50
+
+	// Stand-in for IRsend : Logs the waveform, MARK first
+	unsigned long  wave[1024];
+	int            waveLen;
+	int            waveKhz;
+
+	class IRsend
+	{
+		public:
+			void  enableIROut     (int khz)            { waveLen = 0;  waveKhz = khz; }
+			void  mark            (unsigned int usec)  { wave[waveLen++] = usec; }
+			void  space           (unsigned int usec)  { if (usec)  wave[waveLen++] = usec ; }  // Not the closing space(0)
+			void  sendRawPacked_P (const uint8_t *code_P) ;
+	};
+#endif // TEST
+
+//+=============================================================================
+// Send a packed code [see the top of this file]
+//
+void  IRsend::sendRawPacked_P (const uint8_t *code_P)
+{
+	unsigned int  unit = pgm_read_byte(&code_P[1]) | (pgm_read_byte(&code_P[2]) << 8);
+	unsigned int  pair[2];  // The last MARK and SPACE, for a run
+	uint8_t       level = 0;  // 0 -> Next is a MARK
+
+	enableIROut(pgm_read_byte(&code_P[0]));
+
+	for (code_P += 3;  ;  ) {
+		uint8_t        b = pgm_read_byte(code_P++);
+		unsigned long  t;
+
+		if (b == 0) {
+			uint8_t  n = pgm_read_byte(code_P++);
+
+			if (!n)  break ;
+			while (n--) {
+				mark (pair[0]);
+				space(pair[1]);
+			}
+			continue;
+		}
+
+		t = b;
+		if (b & 0x80)  t = ((unsigned int)(b & 0x7F) << 8) | pgm_read_byte(code_P++) ;
+		t *= unit;
+		if (t > 0xFFFF)  t = 0xFFFF ;
+
+		pair[level] = t;
+		if (level)  space(t);
+		else        mark (t);
+		level ^= 1;
+	}
+
+	space(0);  // Always end with the LED off
+}
+
+//+=============================================================================
+#if TEST
+
+//+=============================================================================
+// Pack n durations [uS] in 'unit' uS
+// Returns the length of the record, or 0 if a duration is more than 10%
+//   [or a tick, if more] from a whole number of units
+// worst : The largest difference
+//
+static int  rawPack (const unsigned long *d,  int n,  int khz,  unsigned int unit,  uint8_t *out,  unsigned long *worst)
+{
+	unsigned int  q[1024];
+	int           len = 0;
+
+	*worst = 0;
+	for (int i = 0;  i < n;  i++) {
+		unsigned long  err;
+
+		q[i] = (d[i] + (unit / 2)) / unit;
+		if (d[i] && !q[i])  q[i] = 1 ;
+		if (q[i] > 0x7FFF)  return 0 ;
+
+		err = (q[i] * unit > d[i]) ? (q[i] * unit - d[i]) : (d[i] - q[i] * unit);
+		if ((err > d[i] / 10) && (err > USECPERTICK))  return 0 ;
+		if (err > *worst)  *worst = err ;
+	}
+
+	out[len++] = khz;
+	out[len++] = unit & 0xFF;
+	out[len++] = unit >> 8;
+
+	for (int i = 0;  i < n;  ) {
+		// The same pair as the one before, over and over
+		if (!(i & 1) && (i >= 2)) {
+			int  run = 0;
+
+			while ((i + 1 < n) && (q[i] == q[i - 2]) && (q[i + 1] == q[i - 1]) && (run < 255)) {
+				run++;
+				i += 2;
+			}
+			if (run) {
+				out[len++] = 0;
+				out[len++] = run;
+				continue;
+			}
+		}
+
+		if (q[i] && (q[i] < 0x80)) {
+			out[len++] = q[i];
+		} else {
+			out[len++] = 0x80 | (q[i] >> 8);
+			out[len++] = q[i] & 0xFF;
+		}
+		i++;
+	}
+
+	out[len++] = 0;
+	out[len++] = 0;
+	return len;
+}
+
+//+=============================================================================
+// Pack in the unit that gives the smallest record [then the smallest error]
+//
+static int  rawPackBest (const unsigned long *d,  int n,  int khz,  uint8_t *out,  unsigned int *unit,  unsigned long *worst)
+{
+	uint8_t        rec[2048];
+	int            best = 0;
+
+	for (unsigned int u = 10;  u <= 2000;  u++) {
+		unsigned long  w;
+		int            len = rawPack(d, n, khz, u, rec, &w);
+
+		if (!len)  continue ;
+		if (!best || (len < best) || ((len == best) && (w < *worst))) {
+			best   = len;
+			*unit  = u;
+			*worst = w;
+			memcpy(out, rec, len);
+		}
+	}
+	return best;
+}
+
+//+=============================================================================
+// Durations from a dump : The {...} of IRrecvDumpV2's rawData[], else what
+// follows its "Timing[n]:", else every number [IRrecord's " m8950 s4450 ..."]
+//
+static int  rawParse (char *s,  unsigned long *d,  int max)
+{
+	char  *end = NULL;
+	char  *cp;
+	int   n = 0;
+
+	if ((cp = strchr(s, '{'))) {
+		end = strchr(++cp, '}');
+	} else if ((cp = strstr(s, "Timing["))) {
+		cp = strchr(cp, ':');
+		if (cp)  for (end = ++cp;  *end && !isalpha(*end);  end++) ;
+	} else {
+		cp = s;
+	}
+	if (!cp)  return 0 ;
+	if (!end)  end = cp + strlen(cp) ;
+
+	while ((cp < end) && (n < max)) {
+		if (isdigit(*cp))  d[n++] = strtoul(cp, &cp, 10) ;
+		else               cp++ ;
+	}
+	return n;
+}
+
+//+=============================================================================
+// Pack a code, send it, and compare what reached the LED with the original
+//
+static bool  rawCheck (IRsend *irsend,  const char *name,  const unsigned long *d,  int n,  int khz)
+{
+	uint8_t        rec[2048];
+	unsigned int   unit;
+	unsigned long  worst = 0;
+	unsigned long  most  = 0;
+	int            len   = rawPackBest(d, n, khz, rec, &unit, &worst);
+	bool           ok    = len && (n <= 1024);
+
+	if (ok) {
+		irsend->sendRawPacked_P(rec);
+		ok = (waveLen == n) && (waveKhz == khz);
+		for (int i = 0;  ok && (i < n);  i++) {
+			unsigned long  err = (wave[i] > d[i]) ? wave[i] - d[i] : d[i] - wave[i];
+
+			if (err > worst)  ok = false ;
+			if (d[i] && (err * 1000 / d[i] > most))  most = err * 1000 / d[i] ;
+		}
+	}
+
+	printf("%-8s %3d durations : %4d bytes as unsigned int[], %3d packed [unit %4uuS]; worst error %3luuS, %2lu.%lu%% : %s\n",
+	       name, n, n * 2, len, unit, worst, most / 10, most % 10, ok ? "OK" : "DIFFERENT");
+	return ok;
+}
+
+//+=============================================================================
+// A test code : MARK hdr, SPACE hdr, then 'bits' bits of 'bytes' as
+//   MARK bit + SPACE zero/one, a closing MARK
+// Each duration is off by up to +/-'jitter' uS, then rounded to a tick, as captured
+//
+static int  rawMake (unsigned long *d,  unsigned long hdrMark,  unsigned long hdrSpace,  unsigned long bit,
+                     unsigned long zero,  unsigned long one,  const uint8_t *bytes,  int bits,  int jitter)
+{
+	static unsigned long  seed = 1;
+	int                   n    = 0;
+
+	d[n++] = hdrMark;
+	d[n++] = hdrSpace;
+	for (int i = 0;  i < bits;  i++) {
+		d[n++] = bit;
+		d[n++] = (bytes[i / 8] & (0x80 >> (i % 8))) ? one : zero;
+	}
+	d[n++] = bit;
+
+	for (int i = 0;  jitter && (i < n);  i++) {
+		seed = seed * 1103515245 + 12345;
+		d[i] += (long)((seed >> 16) % (2 * jitter + 1)) - jitter;
+		d[i]  = (d[i] + (USECPERTICK / 2)) / USECPERTICK * USECPERTICK;
+	}
+	return n;
+}
+
+int  main (int argc,  char* argv[])
+{
+	IRsend         irsend;
+	unsigned long  d[1024];
+	int            n;
+
+	// Pack a code
+	if ((argc == 2) || (argc == 3)) {
+		static char    in[65536];
+		uint8_t        rec[2048];
+		unsigned int   unit;
+		unsigned long  worst;
+		int            khz = (argc == 3) ? atoi(argv[2]) : 38;
+		int            len;
+
+		in[fread(in, 1, sizeof(in) - 1, stdin)] = '\0';
+		n   = rawParse(in, d, 1024);
+		len = n ? rawPackBest(d, n, khz, rec, &unit, &worst) : 0;
+		if (!len) {
+			fprintf(stderr, "No durations that pack\n");
+			return 1;
+		}
+
+		printf("// %d durations : %d bytes as unsigned int[], %d packed; unit %uuS, worst error %luuS\n", n, n * 2, len, unit, worst);
+		printf("const uint8_t  %s[%d] PROGMEM = {", argv[1], len);
+		for (int i = 0;  i < len;  i++)  printf("%s%u", (i == 0) ? "" : ((i % 16) ? "," : ",\n\t"), rec[i]) ;
+		printf("};\n");
+		return 0;
+	}
+
+	// Captured the way IRrecvDumpV2 prints them : NEC, Sony, and an air
+	// conditioner [Mitsubishi, 18 bytes]; Two of them with a little jitter
+	static const uint8_t  nec[]  = { 0x20, 0xDF, 0x10, 0xEF };
+	static const uint8_t  sony[] = { 0xA9, 0x00 };
+	static const uint8_t  ac[]   = { 0x23, 0xCB, 0x26, 0x01, 0x00, 0x20, 0x08, 0x06, 0x30,
+	                                 0x45, 0x67, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F };
+	static char           dumpV2[] =
+		"unsigned int  rawData[67] = {9000,4450, 600,550, 550,600, 600,1650, 550,600, 550,550, 600,550, 550,600, "
+		"550,550, 600,1650, 550,1700, 550,550, 600,1650, 550,1700, 550,1650, 600,1650, 550,1700, 550,550, 600,550, "
+		"550,600, 550,1650, 600,550, 550,600, 550,550, 600,550, 550,1700, 550,1650, 600,1650, 550,600, 550,1650, "
+		"600,1650, 550,1700, 550,1650, 600};  // NEC 20DF10EF";
+	int                   failed = 0;
+
+	n = rawParse(dumpV2, d, 1024);
+	if (!rawCheck(&irsend, "dumpV2", d, n, 38))  failed++ ;
+
+	n = rawMake(d, 9000, 4500, 560, 560, 1690, nec, 32, 0);
+	if (!rawCheck(&irsend, "NEC", d, n, 38))  failed++ ;
+
+	// Sony : The MARK carries the bit
+	n      = 0;
+	d[n++] = 2400;
+	d[n++] = 600;
+	for (int i = 0;  i < 12;  i++) {
+		d[n++] = (sony[i / 8] & (0x80 >> (i % 8))) ? 1200 : 600;
+		d[n++] = 600;
+	}
+	n--;
+	if (!rawCheck(&irsend, "Sony", d, n, 40))  failed++ ;
+
+	n = rawMake(d, 3400, 1750, 450, 420, 1300, ac, 18 * 8, 60);
+	if (!rawCheck(&irsend, "AC", d, n, 38))  failed++ ;
+
+	// The same frame twice, 17mS apart
+	memcpy(&d[n + 1], d, n * sizeof(d[0]));
+	d[n] = 17000;
+	if (!rawCheck(&irsend, "AC x2", d, 2 * n + 1, 38))  failed++ ;
+
+	return failed ? 1 : 0;
+}
+
+#endif // TEST
+
+#endif // SEND_RAW_PACKED
@@ -1,5 +1,9 @@
 #include "IRremote.h"
 #include "IRremoteInt.h"
+
+#ifdef IR_RECV_PIN
+#	include <assert.h>
+#endif
 
 #ifdef IR_TIMER_USE_ESP32
 hw_timer_t *timer;
@@ -7,112 +11,459 @@ void IRTimer(); // defined in IRremote.cpp
 #endif
 
 //+=============================================================================
-// Decodes the received IR message
-// Returns 0 if no data ready, 1 if data ready.
-// Results of decoding are stored in results
+// Header signatures of the compiled-in decoders, in the order they are tried
+// Where two protocols accept the same frame, the first one listed wins
 //
-int  IRrecv::decode (decode_results *results)
-{
-	results->rawbuf   = irparams.rawbuf;
-	results->rawlen   = irparams.rawlen;
+static const irsig_t * const  signatures[] PROGMEM = {
+#if DECODE_NEC
+	&necSignature,
+#endif
+#if DECODE_SONY
+	&sonySignature,
+#endif
+#if DECODE_SANYO
+	&sanyoSignature,
+#endif
+#if DECODE_MITSUBISHI
+	&mitsubishiSignature,
+#endif
+#if DECODE_RC5
+	&rc5Signature,
+#endif
+#if DECODE_RC6
+	&rc6Signature,
+#endif
+#if DECODE_PANASONIC
+	&panasonicSignature,
+#endif
+#if DECODE_LG
+	&lgSignature,
+#endif
+#if DECODE_JVC
+	&jvcSignature,
+#endif
+#if DECODE_SAMSUNG
+	&samsungSignature,
+#endif
+#if DECODE_WHYNTER
+	&whynterSignature,
+#endif
+#if DECODE_AIWA_RC_T501
+	&aiwaSignature,
+#endif
+#if DECODE_DENON
+	&denonSignature,
+#endif
+	NULL  // Not a signature; Keeps the table legal when every DECODE_ is 0
+};
 
-	results->overflow = irparams.overflow;
+#define SIGNATURES  (sizeof(signatures) / sizeof(signatures[0]) - 1)
 
-	if (irparams.rcvstate != STATE_STOP)  return false ;
+//+=============================================================================
+// Run the decoder for one protocol
+// results is unused when no decoder is compiled in [-DIR_DECODE_ALL=0]
+//
+bool  IRrecv::decodeProtocol (int8_t type,  decode_results *results __attribute__((unused)))
+{
+#if IR_RESULT_BITS
+	results->data.clear();  // Of any decoder tried before
+#endif
 
+	switch (type) {
 #if DECODE_NEC
-	DBG_PRINTLN("Attempting NEC decode");
-	if (decodeNEC(results))  return true ;
+		case NEC:
+			DBG_PRINTLN("Attempting NEC decode");
+			return decodeNEC(results);
 #endif
-
 #if DECODE_SONY
-	DBG_PRINTLN("Attempting Sony decode");
-	if (decodeSony(results))  return true ;
+		case SONY:
+			DBG_PRINTLN("Attempting Sony decode");
+			return decodeSony(results);
 #endif
-
 #if DECODE_SANYO
-	DBG_PRINTLN("Attempting Sanyo decode");
-	if (decodeSanyo(results))  return true ;
+		case SANYO:
+			DBG_PRINTLN("Attempting Sanyo decode");
+			return decodeSanyo(results);
 #endif
-
 #if DECODE_MITSUBISHI
-	DBG_PRINTLN("Attempting Mitsubishi decode");
-	if (decodeMitsubishi(results))  return true ;
+		case MITSUBISHI:
+			DBG_PRINTLN("Attempting Mitsubishi decode");
+			return decodeMitsubishi(results);
 #endif
-
 #if DECODE_RC5
-	DBG_PRINTLN("Attempting RC5 decode");
-	if (decodeRC5(results))  return true ;
+		case RC5:
+			DBG_PRINTLN("Attempting RC5 decode");
+			return decodeRC5(results);
 #endif
-
 #if DECODE_RC6
-	DBG_PRINTLN("Attempting RC6 decode");
-	if (decodeRC6(results))  return true ;
+		case RC6:
+			DBG_PRINTLN("Attempting RC6 decode");
+			return decodeRC6(results);
 #endif
-
 #if DECODE_PANASONIC
-	DBG_PRINTLN("Attempting Panasonic decode");
-	if (decodePanasonic(results))  return true ;
+		case PANASONIC:
+			DBG_PRINTLN("Attempting Panasonic decode");
+			return decodePanasonic(results);
 #endif
-
 #if DECODE_LG
-	DBG_PRINTLN("Attempting LG decode");
-	if (decodeLG(results))  return true ;
+		case LG:
+			DBG_PRINTLN("Attempting LG decode");
+			return decodeLG(results);
 #endif
-
 #if DECODE_JVC
-	DBG_PRINTLN("Attempting JVC decode");
-	if (decodeJVC(results))  return true ;
+		case JVC:
+			DBG_PRINTLN("Attempting JVC decode");
+			return decodeJVC(results);
 #endif
-
 #if DECODE_SAMSUNG
-	DBG_PRINTLN("Attempting SAMSUNG decode");
-	if (decodeSAMSUNG(results))  return true ;
+		case SAMSUNG:
+			DBG_PRINTLN("Attempting SAMSUNG decode");
+			return decodeSAMSUNG(results);
 #endif
-
 #if DECODE_WHYNTER
-	DBG_PRINTLN("Attempting Whynter decode");
-	if (decodeWhynter(results))  return true ;
+		case WHYNTER:
+			DBG_PRINTLN("Attempting Whynter decode");
+			return decodeWhynter(results);
 #endif
-
 #if DECODE_AIWA_RC_T501
-	DBG_PRINTLN("Attempting Aiwa RC-T501 decode");
-	if (decodeAiwaRCT501(results))  return true ;
+		case AIWA_RC_T501:
+			DBG_PRINTLN("Attempting Aiwa RC-T501 decode");
+			return decodeAiwaRCT501(results);
 #endif
-
 #if DECODE_DENON
-	DBG_PRINTLN("Attempting Denon decode");
-	if (decodeDenon(results))  return true ;
+		case DENON:
+			DBG_PRINTLN("Attempting Denon decode");
+			return decodeDenon(results);
+#endif
+		default:
+			return false;
+	}
+}
+
+//+=============================================================================
+// Try, in signatures[] order, every decoder whose header signature fits
+// only : Try just this protocol [UNKNOWN = all]
+// skip : Do not try this protocol [already tried]
+//
+bool  IRrecv::decodeMatching (decode_results *results,  int8_t only,  int8_t skip)
+{
+	unsigned int  mark  = results->rawAt(1);
+	unsigned int  space = results->rawAt(2);
+
+	for (uint8_t i = 0;  i < SIGNATURES;  i++) {
+		const irsig_t  *ref;
+		irsig_t        sig;
+
+		memcpy_P(&ref, &signatures[i], sizeof(ref));
+		memcpy_P(&sig, ref, sizeof(sig));
+
+		if ((only != UNKNOWN) && (sig.type != only))  continue ;
+		if (sig.type == skip)                          continue ;
+		if (!MATCH_TICKS(mark, sig.mark) || !MATCH_TICKS(space, sig.space))  continue ;
+
+		if (decodeProtocol(sig.type, results)) {
+#if IR_RESULT_BITS
+			// A decoder of 32 bits or less may leave it to value
+			if (!results->data.count && (results->bits <= 32))  results->data.append(results->value, results->bits) ;
+#endif
+			recent = sig.type;
+			return true;
+		}
+	}
+	return false;
+}
+
+#if IR_GLITCH_TICKS
+//+=============================================================================
+// Write a merged duration back to a slot, escaping it as the ISR would
+//
+static void  putTicks (volatile irslot_t *slot,  int i,  unsigned int ticks)
+{
+#if IR_COMPACT_RAWBUF
+	if (ticks >= IR_RAW_ESCAPE) {
+		uint8_t  b = slot->rawbuf[i];
+
+		if (b < IR_RAW_ESCAPE) {
+			if (slot->rawlongs >= IR_RAW_LONGS) {
+				slot->rawbuf[i] = IR_RAW_ESCAPE - 1;  // Out of escapes: clip, decoders only see "long"
+				return;
+			}
+			b = IR_RAW_ESCAPE + slot->rawlongs++;
+		}
+		slot->rawlong[b - IR_RAW_ESCAPE] = ticks;
+		ticks = b;
+	}
+#endif
+	slot->rawbuf[i] = ticks;
+}
+
+//+=============================================================================
+// Merge every MARK or SPACE of IR_GLITCH_TICKS or less, and the durations
+// either side of it, into one; So a spike of ambient IR in a SPACE, or a
+// dropout in a MARK, no longer splits it in three.
+// A glitch as the last MARK is dropped, with the SPACE before it.
+// Works in place; Running it again changes nothing.
+//
+void  IRrecv::filterGlitches (decode_results *results)
+{
+	volatile irslot_t  *slot = &irparams.slot[IR_SLOT(irparams.tail)];
+	int                 len  = results->rawlen;
+	int                 w    = 0;  // Last duration kept [the gap always is]
+
+	for (int r = 1;  r < len;  r++) {
+		unsigned int  t = results->rawAt(r);
+
+		if (t > IR_GLITCH_TICKS) {
+			slot->rawbuf[++w] = slot->rawbuf[r];  // Escapes still point at their rawlong
+		} else if (r + 1 < len) {
+			putTicks(slot, w, results->rawAt(w) + t + results->rawAt(r + 1));
+			r++;
+		} else if (w >= 2) {
+			w--;
+		} else {
+			slot->rawbuf[++w] = slot->rawbuf[r];
+		}
+	}
+
+	slot->rawlen    = w + 1;
+	results->rawlen = w + 1;
+}
+#endif
+
+//+=============================================================================
+// Hands over the oldest captured frame without decoding it
+// Only rawbuf, rawlen and overflow are filled in; decode_type is UNKNOWN.
+// Glitches are already merged away [see IR_GLITCH_TICKS].
+// The frame stays ours until resume(); decode() may still be run on it.
+// Until then the ISR leaves the slot alone, so it is read as plain memory.
+//
+bool  IRrecv::capture (decode_results *results)
+{
+#if IR_RECV_EDGE
+	// No timer tick notices the closing gap in edge mode, so check it here
+	IREdgeTimeout();
+#endif
+
+#if IR_RECV_SHARED
+	// A blocking send has finished with the timer [an IR_SEND_ASYNC one gives it back itself]
+#	if IR_SEND_ASYNC
+	if (irparams.lent && irparams.armed && (irsendparams.head == irsendparams.tail)) {
+#	else
+	if (irparams.lent && irparams.armed) {
+#	endif
+		noInterrupts();
+		IRrecvReclaim();
+		interrupts();
+	}
+#endif
+
+#if IR_SEND_ASYNC
+	// Relayed frames belong to the sender
+	if (irsendparams.relay || irsendparams.relayed)  return false ;
+#endif
+
+	// Nothing to do until the ISR has completed a slot
+	if (irparams.head == irparams.tail)  return false ;
+
+	// The oldest completed slot; it stays ours until resume()
+	volatile irslot_t  *slot = &irparams.slot[IR_SLOT(irparams.tail)];
+
+	results->decode_type = UNKNOWN;
+	results->rawbuf      = (const irraw_t *)slot->rawbuf;
+#if IR_COMPACT_RAWBUF
+	results->rawlong     = (const unsigned int *)slot->rawlong;
+#endif
+	results->rawlen      = slot->rawlen;
+	results->tick        = USECPERTICK;
+	results->overflow    = slot->overflow;
+	results->stamp       = slot->stamp;
+#if IR_GLITCH_TICKS
+	filterGlitches(results);
+#endif
+	return true;
+}
+
+//+=============================================================================
+// Decodes the received IR message
+// Returns 0 if no data ready, 1 if data ready.
+// Results of decoding are stored in results
+//
+int  IRrecv::decode (decode_results *results)
+{
+	if (!capture(results))  return false ;
+
+#if IR_RECV_STREAM
+	volatile irslot_t  *slot = &irparams.slot[IR_SLOT(irparams.tail)];
+
+	// The ISR has already decoded it
+	if (slot->streamed && decodeStreamed(results, slot)) {
+		recent = results->decode_type;
+		return true;
+	}
 #endif
 
-#if DECODE_LEGO_PF
-	DBG_PRINTLN("Attempting Lego Power Functions");
-	if (decodeLegoPowerFunctions(results))  return true ;
+#if IR_DECODE_CACHE
+	// The same frame as last time
+	if (decodeCached(results))  return true ;
 #endif
 
+	if (!decodeFrame(results)) {
+		// Throw away and start over
+		resume();
+		return false;
+	}
+
+#if IR_DECODE_CACHE
+	cacheResult(results);
+#endif
+	return true;
+}
+
+//+=============================================================================
+// Decode durations from anywhere : A copy, a file, a host corpus ...
+// buf[0] is the gap before the frame, then MARK, SPACE, MARK ... in counts of
+// tick uS.  It is read in place and the receiver is left alone.
+// With IR_COMPACT_RAWBUF, point results->rawlong at buf's escaped durations.
+//
+bool  IRrecv::decodeSpan (decode_results *results,  const irraw_t *buf,  int len,  uint8_t tick)
+{
+	results->decode_type = UNKNOWN;
+	results->rawbuf      = buf;
+	results->rawlen      = len;
+	results->tick        = tick;
+	results->overflow    = false;
+
+	return (len > 2) && decodeFrame(results);
+}
+
+//+=============================================================================
+// Run the decoders over the frame results views
+//
+bool  IRrecv::decodeFrame (decode_results *results)
+{
+	// The protocol that decoded last is the likeliest, so try it first
+	if (locked != UNKNOWN)  return decodeMatching(results, locked, UNKNOWN) ;
+
+	if ((recent != UNKNOWN) && decodeMatching(results, recent, UNKNOWN))  return true ;
+	if (decodeMatching(results, UNKNOWN, recent))  return true ;
+
 	// decodeHash returns a hash on any input.
 	// Thus, it needs to be last in the list.
-	// If you add any decodes, add them before this.
-	if (decodeHash(results))  return true ;
+	// If you add any decodes, add them to signatures[] instead.
+	return decodeHash(results);
+}
+
+#if IR_DECODE_CACHE
+//+=============================================================================
+// Answer from the cache if the frame is the one decoded last : The same
+// length, and every duration within 1/8 [+1 tick] of the one kept.
+// Only protocol decoders' results are kept [see cacheResult()] : Their bits
+// are 2:1 or more apart, and the window is well inside their 25% tolerance,
+// so a frame that hits is one they would decode the same.
+//
+bool  IRrecv::decodeCached (decode_results *results)
+{
+	if (!cacheLen || (results->rawlen != cacheLen))  goto miss ;
+
+	for (uint8_t i = 1;  i < cacheLen;  i++) {
+		unsigned int  t    = results->rawAt(i);
+		unsigned int  c    = cacheRaw[i - 1];
+		unsigned int  diff;
 
-	// Throw away and start over
-	resume();
+		diff = (t > c) ? t - c : c - t;
+		if (diff > (c >> 3) + 1)  goto miss ;
+	}
+
+	results->decode_type = (decode_type_t)cacheType;
+	results->address     = cacheAddress;
+	results->value       = cacheValue;
+	results->bits        = cacheBits;
+#if IR_RESULT_BITS
+	results->data        = cacheData;
+#endif
+	hits++;
+	return true;
+
+miss:
+	misses++;
 	return false;
 }
 
+//+=============================================================================
+// Keep a frame that has just decoded, and its result
+// Not a hash [UNKNOWN] : Frames of any shape hash, and two buttons may differ
+// by less than the cache window.  Nor a frame with a duration too long for a
+// byte, which could not be told apart from a longer one.
+//
+void  IRrecv::cacheResult (decode_results *results)
+{
+	cacheLen = 0;
+	if (results->decode_type == UNKNOWN)  return ;
+
+	for (uint8_t i = 1;  i < results->rawlen;  i++) {
+		unsigned int  t = results->rawAt(i);
+
+		if (t > 255)  return ;
+		cacheRaw[i - 1] = t;
+	}
+	cacheLen = results->rawlen;
+
+	cacheType    = results->decode_type;
+	cacheAddress = results->address;
+	cacheValue   = results->value;
+	cacheBits    = results->bits;
+#if IR_RESULT_BITS
+	cacheData    = results->data;
+#endif
+}
+
+//+=============================================================================
+// Frames decode() has answered from the cache, and ones it has not
+//
+unsigned int  IRrecv::cacheHits ( )
+{
+	return hits;
+}
+
+unsigned int  IRrecv::cacheMisses ( )
+{
+	return misses;
+}
+#endif
+
 //+=============================================================================
 IRrecv::IRrecv (int recvpin)
 {
+#ifdef IR_RECV_PIN
+	assert(recvpin == IR_RECV_PIN);  // The ISR only reads IR_RECV_PIN
+#endif
 	irparams.recvpin = recvpin;
 	irparams.blinkflag = 0;
+	recent = UNKNOWN;
+	locked = UNKNOWN;
+#if IR_DECODE_CACHE
+	cacheLen = 0;
+	hits     = 0;
+	misses   = 0;
+#endif
 }
 
 IRrecv::IRrecv (int recvpin, int blinkpin)
 {
+#ifdef IR_RECV_PIN
+	assert(recvpin == IR_RECV_PIN);  // The ISR only reads IR_RECV_PIN
+#endif
 	irparams.recvpin = recvpin;
 	irparams.blinkpin = blinkpin;
 	pinMode(blinkpin, OUTPUT);
 	irparams.blinkflag = 0;
+	recent = UNKNOWN;
+	locked = UNKNOWN;
+#if IR_DECODE_CACHE
+	cacheLen = 0;
+	hits     = 0;
+	misses   = 0;
+#endif
 }
 
 
@@ -122,8 +473,17 @@ IRrecv::IRrecv (int recvpin, int blinkpin)
 //
 void  IRrecv::enableIRIn ( )
 {
+#if IR_SEND_ASYNC
+	while (irsendparams.head != irsendparams.tail) ;  // The sender has the timer until its queue is empty
+#endif
+
+#if IR_RECV_EDGE
+	// No timer needed; the first edge is measured from now
+	irparams.lastlevel = SPACE;
+	irparams.lastedge  = micros();
+
 // Interrupt Service Routine - Fires every 50uS
-#ifdef ESP32
+#elif defined(ESP32)
 	// ESP32 has a proper API to setup timers, no weird chip macros needed
 	// simply call the readable API versions :)
 	// 3 timers, choose #1, 80 divider nanosecond precision, 1 to count up
@@ -139,6 +499,8 @@ void  IRrecv::enableIRIn ( )
 	// Therefore, the timer interval can range from 0.5 to 128 microseconds
 	// Depending on the reset value (255 to 0)
 	TIMER_CONFIG_NORMAL();
+	TIMER_CONFIG_IDLE();  // Nothing to capture until the first MARK
+	IR_ECHO_LED(false);   // The timer no longer drives the LED
 
 	// Timer2 Overflow Interrupt Enable
 	TIMER_ENABLE_INTR;
@@ -151,11 +513,59 @@ void  IRrecv::enableIRIn ( )
 	// Initialize state machine variables
 	irparams.rcvstate = STATE_IDLE;
 	irparams.rawlen = 0;
+	irparams.head = 0;
+	irparams.tail = 0;
+	irparams.dropped = 0;
+#if IR_RECV_SHARED
+	irparams.armed = true;
+	irparams.lent = false;
+#endif
 
 	// Set pin modes
 	pinMode(irparams.recvpin, INPUT);
+
+#if IR_RECV_EDGE
+	// Interrupt Service Routine - Fires on every edge of the receive pin
+	// IR_RECV_PIN's external interrupt if it has one, else its pin-change group
+	// [see boarddefs.h]
+#	if defined(IR_RECV_INT)
+	attachInterrupt(IR_RECV_INT, IREdge, CHANGE);
+#	elif defined(IR_RECV_PCINT)
+	*digitalPinToPCMSK(irparams.recvpin) |= _BV(digitalPinToPCMSKbit(irparams.recvpin));
+	*digitalPinToPCICR(irparams.recvpin) |= _BV(digitalPinToPCICRbit(irparams.recvpin));
+#	else
+#		error "IR_RECV_EDGE needs an edge interrupt : Set IR_RECV_PIN to the detector's pin [see boarddefs.h]"
+#	endif
+#endif
 }
 
+#if IR_RECV_SHARED
+//+=============================================================================
+// Put the timer back as enableIRIn() set it, after IRsend had it for the
+// carrier.  Captures carry on from where they were : On a timer with
+// TIMER_CARRIER_CLOCKS the receiver kept sampling; Else it heard nothing,
+// so a frame it was part way through is dropped.
+// Run with interrupts off
+//
+void  IRrecvReclaim ( )
+{
+	irparams.lent = false;
+
+#ifndef TIMER_CARRIER_CLOCKS
+	if ((irparams.rcvstate == STATE_MARK) || (irparams.rcvstate == STATE_SPACE))  irparams.rcvstate = STATE_IDLE ;
+	irparams.timer = 0;
+#endif
+
+#ifndef ESP32
+	TIMER_CONFIG_NORMAL();  // Also disconnects the carrier from the pin
+	IR_ECHO_LED(false);
+	if ((irparams.rcvstate != STATE_MARK) && (irparams.rcvstate != STATE_SPACE))  TIMER_CONFIG_IDLE() ;
+	TIMER_ENABLE_INTR;
+	TIMER_RESET;
+#endif
+}
+#endif
+
 //+=============================================================================
 // Enable/disable blinking of pin 13 on IR processing
 //
@@ -170,66 +580,282 @@ void  IRrecv::blink13 (int blinkflag)
 //
 bool  IRrecv::isIdle ( )
 {
+#if IR_RECV_EDGE
+	IREdgeTimeout();
+#endif
  return (irparams.rcvstate == STATE_IDLE || irparams.rcvstate == STATE_STOP) ? true : false;
 }
 //+=============================================================================
-// Restart the ISR state machine
+// Release the slot returned by decode() so the ISR can reuse it
+// If the ISR had stopped because every slot was full, restart it
+// Relaying, the sender releases the slots instead, and this does nothing.
 //
 void  IRrecv::resume ( )
 {
-	irparams.rcvstate = STATE_IDLE;
-	irparams.rawlen = 0;
+#if IR_SEND_ASYNC
+	if (irsendparams.relay || irsendparams.relayed)  return ;
+#endif
+
+	if (irparams.head != irparams.tail)  irparams.tail++ ;
+	if (irparams.rcvstate == STATE_STOP)  irparams.rcvstate = STATE_IDLE ;
 }
 
+#if IR_SEND_ASYNC
 //+=============================================================================
-// hashdecode - decode an arbitrary IR code.
-// Instead of decoding using a standard encoding scheme
-// (e.g. Sony, NEC, RC5), the code is hashed to a 32-bit value.
+// Relay : As the ISR completes each slot, it queues it straight to the sender as
+// the raw MARKs and SPACEs, and the sender frees it once it is sent.  Nothing
+// is copied or decoded, and the main loop has no part in it [In edge mode
+// IR_RECV_EDGE, keep calling capture() : It is what closes each frame].
+// A frame is sent once its closing gap is seen, so it goes out _GAP after it
+// ended here.  Frames with nowhere to go are counted in dropped().
+// From now until relay(0) and the last relayed frame is out, only the sender's
+// ISR moves 'tail' : capture() and decode() see no frames and resume() does
+// nothing, so the ring keeps a single writer at each end.
+// Call it with no frame held [after resume()].  Needs IR_FULL_DUPLEX.
+// Frames the ISR streams [see lockProtocol()] are cut at their last bit.
 //
-// The algorithm: look at the sequence of MARK signals, and see if each one
-// is shorter (0), the same length (1), or longer (2) than the previous.
-// Do the same with the SPACE signals.  Hash the resulting sequence of 0's,
-// 1's, and 2's to a 32-bit value.  This will give a unique value for each
-// different code (probably), for most code systems.
-//
-// http://arcfn.com/2010/01/using-arbitrary-remotes-with-arduino.html
+void  IRrecv::relay (uint8_t khz,  bool excess)
+{
+	irsendparams.excess = excess;
+	irsendparams.relay  = khz;
+}
+#endif
+
+//+=============================================================================
+// Number of frames thrown away since enableIRIn() because every slot was full
 //
-// Compare two tick values, returning 0 if newval is shorter,
-// 1 if newval is equal, and 2 if newval is longer
-// Use a tolerance of 20%
+unsigned int  IRrecv::dropped ( )
+{
+	return irparams.dropped;
+}
+
+//+=============================================================================
+// Once the remote in use is known, skip every other decoder [and the hash]
+// UNKNOWN goes back to trying them all
+// With IR_RECV_STREAM, a protocol with a header and a fixed number of bits that
+//   may be followed by more [not IR_PD_EXACT] is also decoded by the ISR as it
+//   arrives [see streamTicks() in IRremote.cpp]
 //
-int  IRrecv::compare (unsigned int oldval,  unsigned int newval)
+void  IRrecv::lockProtocol (decode_type_t type)
 {
-	if      (newval < oldval * .8)  return 0 ;
-	else if (oldval < newval * .8)  return 2 ;
-	else                            return 1 ;
+	locked = type;
+#if IR_DECODE_CACHE
+	cacheLen = 0;  // It may hold a frame of another protocol
+#endif
+
+#if IR_RECV_STREAM
+	const irpulse_t  *proto_P = NULL;
+	uint8_t          framelen = 0;
+
+	for (uint8_t i = 0;  i < SIGNATURES;  i++) {
+		const irsig_t  *ref;
+		irsig_t        sig;
+
+		memcpy_P(&ref, &signatures[i], sizeof(ref));
+		memcpy_P(&sig, ref, sizeof(sig));
+		if ((sig.type == type) && sig.pulse) {
+			irpulse_t  p;
+
+			memcpy_P(&p, sig.pulse, sizeof(p));
+			// IR_PD_EXACT needs the gap to tell it from a longer frame [JVC and Denon]
+			if (p.hdrMark.hi && p.hdrSpace.hi && !(p.flags & (IR_PD_PULSE_WIDTH | IR_PD_EXACT))) {
+				// gap + header + a MARK and a SPACE per bit + the MARK that ends it
+				if (1 + 2 + (2 * p.bits) + 1 <= RAWBUF) {
+					proto_P  = sig.pulse;
+					framelen = 1 + 2 + (2 * p.bits) + 1;
+				}
+			}
+		}
+	}
+
+	// Start on the next frame, not part way through this one
+	noInterrupts();
+	irstream.proto    = proto_P;
+	irstream.framelen = framelen;
+	irstream.end      = 0;
+	interrupts();
+#endif
 }
 
 //+=============================================================================
-// Use FNV hash algorithm: http://isthe.com/chongo/tech/comp/fnv/#FNV-param
-// Converts the raw code values into a 32-bit hash code.
-// Hopefully this code is unique for each button.
-// This isn't a "real" decoding, just an arbitrary value.
+// Fingerprint a frame that no decoder recognised
+//
+// Each duration goes in to a log-scale bucket : 8 per octave, so one bucket
+// is a step of about 9%.  Marks and spaces are bucketed separately.  Runs of
+// used buckets, with no more than one empty bucket between them, are one
+// "level" : a length the remote sends, spread out by jitter.  Protocols keep
+// their lengths well apart [mostly 2:1 or more], so their runs do not touch.
+// The frame is then the sequence of levels of its durations.
+//
+// A duration can change bucket from one press to the next, but not level, so
+// the hash of the levels is the same every time.  The levels, and the bucket
+// each one starts at, are also kept [if fp is not NULL], so that two
+// fingerprints can be compared within a tolerance [fingerprintDistance()].
+//
+// Integer only : A bucket is where the top bit is and the 3 bits below it.
 //
 #define FNV_PRIME_32 16777619
 #define FNV_BASIS_32 2166136261
 
-long  IRrecv::decodeHash (decode_results *results)
+static uint8_t  fingerprintBucket (unsigned int ticks)
 {
-	long  hash = FNV_BASIS_32;
+	uint8_t  top    = (ticks > 255) ? 255 : ticks;  // Spaces stop at the gap; No MARK is longer
+	uint8_t  bucket = 3 * 8;
+
+	if (!top)  top = 1 ;
+
+	// Under 8 ticks there is a bucket per tick, just below those of 8..15
+	if (top < 8)  return 2 * 8 + top ;
+
+	// Shift the top bit to bit 3; The 3 bits below it are the step in the octave
+	while (top >= 16)  top >>= 1, bucket += 8 ;
+	return bucket + (top & 7);
+}
+
+//+=============================================================================
+bool  IRrecv::fingerprint (decode_results *results,  irfingerprint_t *fp)
+{
+	uint8_t        map[IR_FP_BUCKETS] = {0};  // Per bucket, for MARK [low 4 bits] and SPACE: used, then its level
+	uint8_t        start[2][IR_FP_LEVELS];    // First bucket of each level
+	uint8_t        levels[2] = {0, 0};
+	uint8_t        empty[2]  = {2, 2};
+	unsigned long  hash      = FNV_BASIS_32;
+	uint8_t        len;
+	uint8_t        lo        = IR_FP_BUCKETS - 1;  // Range of the used buckets
+	uint8_t        hi        = 0;
 
 	// Require at least 6 samples to prevent triggering on noise
 	if (results->rawlen < 6)  return false ;
+	len = (results->rawlen - 1 < IR_FP_DURATIONS) ? results->rawlen - 1 : IR_FP_DURATIONS;
+
+	for (uint8_t i = 0;  i < len;  i++) {
+		uint8_t  b = fingerprintBucket(results->rawAt(i + 1));
+
+		map[b] |= (i & 1) ? 0x10 : 0x01;
+		if (b < lo)  lo = b ;
+		if (b > hi)  hi = b ;
+	}
+
+	// Split the used buckets in to levels; Two empty buckets in a row end one
+	for (uint8_t b = lo;  b <= hi;  b++) {
+		uint8_t  m = map[b];
+		map[b] = 0;
+		for (uint8_t kind = 0;  kind < 2;  kind++, m >>= 4) {
+			if (!(m & 1)) {
+				empty[kind]++;
+			} else {
+				if ((empty[kind] >= 2) && (levels[kind] < IR_FP_LEVELS))  start[kind][levels[kind]++] = b ;
+				empty[kind] = 0;
+				map[b] |= (levels[kind] - 1) << (4 * kind);
+			}
+		}
+	}
+
+	if (fp) {
+		memset(fp, 0, sizeof(*fp));
+		fp->len = len;
+		memcpy(fp->levels, levels, sizeof(levels));
+		memcpy(fp->start,  start,  sizeof(start));
+	}
+
+	for (uint8_t i = 0;  i < len;  i++) {
+		uint8_t  level = map[fingerprintBucket(results->rawAt(i + 1))];
+
+		level = (i & 1) ? (level >> 4) : (level & 0x0F);
+
+		// Add the level in to the hash [FNV: http://isthe.com/chongo/tech/comp/fnv/#FNV-param]
+		hash = (hash * FNV_PRIME_32) ^ level;
+		if (fp)  fp->level[i / 2] |= level << ((i & 1) ? 4 : 0) ;
+	}
+
+	if (fp)  fp->hash = hash ;
+	results->value = hash;
+	return true;
+}
+
+//+=============================================================================
+// How many durations of b are not at the level they are at in a
+// Gives up, returning more than limit, once it has found more than limit.
+// Frames of different lengths, or whose levels start more than 3 buckets
+// [about 30%] apart, differ everywhere.
+//
+uint8_t  IRrecv::fingerprintDistance (const irfingerprint_t *a,  const irfingerprint_t *b,  uint8_t limit)
+{
+	uint8_t  misses = 0;
+
+	if ((a->len != b->len) || (a->levels[0] != b->levels[0]) || (a->levels[1] != b->levels[1]))  return 255 ;
 
-	for (int i = 1;  (i + 2) < results->rawlen;  i++) {
-		int value =  compare(results->rawbuf[i], results->rawbuf[i+2]);
-		// Add value into the hash
-		hash = (hash * FNV_PRIME_32) ^ value;
+	for (uint8_t kind = 0;  kind < 2;  kind++) {
+		for (uint8_t level = 0;  level < a->levels[kind];  level++) {
+			int  diff = a->start[kind][level] - b->start[kind][level];
+			if ((diff < -3) || (diff > 3))  return 255 ;
+		}
 	}
 
-	results->value       = hash;
+	for (uint8_t i = 0;  i < (a->len + 1) / 2;  i++) {
+		uint8_t  x = a->level[i] ^ b->level[i];
+		if (x & 0x0F)  misses++ ;
+		if (x & 0xF0)  misses++ ;
+		if (misses > limit)  break ;
+	}
+
+	return misses;
+}
+
+//+=============================================================================
+// hashdecode - decode an arbitrary IR code.
+// Instead of decoding using a standard encoding scheme
+// (e.g. Sony, NEC, RC5), the code is hashed to a 32-bit value [see fingerprint()]
+// This isn't a "real" decoding, just an arbitrary value.
+//
+// http://arcfn.com/2010/01/using-arbitrary-remotes-with-arduino.html
+//
+long  IRrecv::decodeHash (decode_results *results)
+{
+	if (!fingerprint(results, NULL))  return false ;
+
 	results->bits        = 32;
 	results->decode_type = UNKNOWN;
+#if IR_RESULT_BITS
+	results->data.clear();
+	results->data.append(results->value, 32);
+#endif
 
 	return true;
 }
+
+#if IR_RESULT_BITS
+//+=============================================================================
+// Bits of any length [see irbits_t]
+//
+void  irbits_t::append (unsigned long value,  uint8_t nbits)
+{
+	while (nbits--)  append((bool)((value >> nbits) & 1)) ;
+}
+
+// The same bits : Only those kept are compared, and the number of them
+bool  irbits_t::equals (const irbits_t *other) const
+{
+	uint8_t  n = (count < IR_RESULT_BITS) ? count : IR_RESULT_BITS;
+
+	if (count != other->count)  return false ;
+
+	for (uint8_t  i = 0;  i < n / 8;  i++)
+		if (byte[i] != other->byte[i])  return false ;
+
+	// Bits past count in the last byte are left over from an earlier frame
+	return !(n & 7) || !((byte[n / 8] ^ other->byte[n / 8]) & (0xFF00 >> (n & 7)));
+}
+
+// FNV-1a of the number of bits and the bits kept; Equal bits hash the same
+unsigned long  irbits_t::hash ( ) const
+{
+	uint8_t        n    = (count < IR_RESULT_BITS) ? count : IR_RESULT_BITS;
+	unsigned long  hash = (FNV_BASIS_32 ^ count) * FNV_PRIME_32;
+
+	for (uint8_t  i = 0;  i < n / 8;  i++)  hash = (hash ^ byte[i]) * FNV_PRIME_32 ;
+	if (n & 7)  hash = (hash ^ (byte[n / 8] & (0xFF00 >> (n & 7)))) * FNV_PRIME_32 ;
+
+	return hash;
+}
+#endif
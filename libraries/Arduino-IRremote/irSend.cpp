@@ -15,12 +15,32 @@ void  IRsend::sendRaw (const unsigned int buf[],  unsigned int len,  unsigned in
 	space(0);  // Always end with the LED off
 }
 
+//+=============================================================================
+// Send the frame an encoder gives, one duration at a time
+//
+void  IRsend::send (IRencoder *enc)
+{
+	unsigned long  usec;
+
+	// Set IR carrier frequency
+	enableIROut(enc->khz);
+
+	for (uint8_t  i = 0;  enc->next(&usec);  i ^= 1) {
+		if (i)  space(0) ;
+		else    mark (0) ;
+		custom_delay_usec(usec);
+	}
+
+	space(0);  // Always end with the LED off
+}
+
 //+=============================================================================
 // Sends an IR mark for the specified number of microseconds.
 // The mark output is modulated at the PWM frequency.
 //
 void  IRsend::mark (unsigned int time)
 {
+	IR_ECHO_LED(true);
 	TIMER_ENABLE_PWM; // Enable pin 3 PWM output
 	if (time > 0) custom_delay_usec(time);
 }
@@ -33,6 +53,7 @@ void  IRsend::mark (unsigned int time)
 void  IRsend::space (unsigned int time)
 {
 	TIMER_DISABLE_PWM; // Disable pin 3 PWM output
+	IR_ECHO_LED(false);
 	if (time > 0) IRsend::custom_delay_usec(time);
 }
 
@@ -51,13 +72,22 @@ void  IRsend::space (unsigned int time)
 // To turn the output on and off, we leave the PWM running, but connect and disconnect the output pin.
 // A few hours staring at the ATmega documentation and this will all make sense.
 // See my Secrets of Arduino PWM at http://arcfn.com/2009/07/secrets-of-arduino-pwm.html for details.
+// With IR_FULL_DUPLEX the receiver has the timer back as soon as capture() is
+// called, and on Timer2 it goes on receiving while the frame is sent.
 //
 void  IRsend::enableIROut (int khz)
 {
+#if IR_SEND_ASYNC
+	while (sendBusy()) ;  // Let the queued frames finish with the timer first
+#endif
+
 // FIXME: implement ESP32 support, see IR_TIMER_USE_ESP32 in boarddefs.h
 #ifndef ESP32
 	// Disable the Timer2 Interrupt (which is used for receiving IR)
 	TIMER_DISABLE_INTR; //Timer2 Overflow Interrupt
+#if IR_RECV_SHARED
+	irparams.lent = true;  // Until IRrecvReclaim()
+#endif
 
 	pinMode(TIMER_PWM_PIN, OUTPUT);
 	digitalWrite(TIMER_PWM_PIN, LOW); // When not sending PWM, we want it low
@@ -68,6 +98,14 @@ void  IRsend::enableIROut (int khz)
 	// CS2  = 000: no prescaling
 	// The top value for the timer.  The modulation frequency will be SYSCLOCK / 2 / OCR2A.
 	TIMER_CONFIG_KHZ(khz);
+
+#	if IR_RECV_SHARED && defined(TIMER_CARRIER_CLOCKS)
+	// Keep the receiver going, off the carrier interrupt
+	if (irparams.armed) {
+		irparams.clocks = 0;
+		TIMER_ENABLE_INTR;
+	}
+#	endif
 #endif
 }
 
@@ -88,3 +126,233 @@ void IRsend::custom_delay_usec(unsigned long uSecs) {
   //}
 }
 
+
+#if IR_SEND_ASYNC
+//+=============================================================================
+// Non-blocking send
+//
+// The frames wait in irsendparams.frame[], a ring like the receiver's capture
+// slots.  While there are any, Timer2 runs as the carrier [as enableIROut()
+// sets it up] and its compare interrupt, once per carrier period, counts down
+// the current MARK or SPACE.  At the end of one it connects or disconnects the
+// carrier from the pin, as mark() and space() do, and loads the next.
+//
+// Durations are timed in whole carrier periods [26uS at 38kHz]; The decoders
+// allow 25%.  A frame that ends with a MARK is followed by a _GAP SPACE, so
+// the next one is not run in to it.  A frame from an IRencoder is asked for
+// each duration as the last one ends [up to a second or so each].
+//
+// With IR_FULL_DUPLEX the receiver has the timer back when the queue empties;
+// Without it, call enableIRIn() once sendBusy() is false.
+//
+
+//+=============================================================================
+// Set the LED for the next MARK or SPACE [of this frame, or of the next one]
+// Only ever run with interrupts off : From the ISR, or to start the queue.
+//
+static void  IRsendNext ( )
+{
+	for (;;) {
+		volatile irframe_t  *f = &irsendparams.frame[IR_SEND_SLOT(irsendparams.tail)];
+		unsigned int        i  = irsendparams.index++;
+		unsigned long       us;
+		unsigned int        periods;
+
+		if (i == 0)  TIMER_CONFIG_KHZ(f->khz) ;  // A new frame; It may use another carrier
+
+		if (f->enc ? f->enc->next(&us) : (i < f->len)) {
+			if (!f->enc)  us = f->progmem ? pgm_read_word(&f->buf[i]) : f->buf[i] ;
+		} else if (i & 1) {
+			us = _GAP;  // Ended on a MARK
+		} else {
+			// Frame sent
+			if (f->enc)  f->enc->sent() ;
+			irsendparams.tail++;
+			irsendparams.index = 0;
+			if (irsendparams.head == irsendparams.tail) {
+				TIMER_DISABLE_PWM;
+				IR_ECHO_LED(false);
+#if IR_RECV_SHARED
+				if (irparams.armed) {
+					IRrecvReclaim();
+					return;
+				}
+#endif
+				TIMER_DISABLE_INTR;
+				return;
+			}
+			continue;
+		}
+
+		periods = (us * f->scale + 32768) >> 16;
+		if (!periods)  continue ;  // space(0) and the like
+
+		IR_ECHO_LED(!(i & 1));
+		if (i & 1)  TIMER_DISABLE_PWM ;
+		else        TIMER_ENABLE_PWM ;
+		irsendparams.periods = periods;
+		return;
+	}
+}
+
+//+=============================================================================
+// One carrier period has passed
+//
+void  IRsendTick ( )
+{
+	if (--irsendparams.periods)  return ;
+	IRsendNext();
+}
+
+#if IR_RECV_EDGE
+// The receiver does not use the timer in edge mode, so it has no ISR of its own
+ISR (TIMER_INTR_NAME)
+{
+	if (irsendparams.head != irsendparams.tail)  IRsendTick() ;
+}
+#endif
+
+//+=============================================================================
+// Add a frame to the queue, and start sending if nothing else is
+// Also run from the receiver's ISR, when relaying
+//
+static int  IRsendQueue (const unsigned int *buf,  IRencoder *enc,  uint8_t len,  uint8_t khz,  uint8_t progmem)
+{
+	uint8_t  pwmval = SYSCLOCK / 2000 / khz;  // As TIMER_CONFIG_KHZ() has it
+	uint8_t  sreg   = SREG;
+	int      ticket;
+
+	cli();
+	if ((uint8_t)(irsendparams.head - irsendparams.tail) >= IR_SEND_QUEUE) {
+		SREG = sreg;
+		return -1;
+	}
+
+	volatile irframe_t  *f = &irsendparams.frame[IR_SEND_SLOT(irsendparams.head)];
+	f->buf     = buf;
+	f->enc     = enc;
+	f->len     = len;
+	f->khz     = khz;
+	f->progmem = progmem;
+	f->scale   = (SYSCLOCK / 62500) * 4096UL / (2 * pwmval);  // 2 * pwmval clocks per period
+
+	ticket = irsendparams.head++;
+	if ((uint8_t)(irsendparams.head - irsendparams.tail) == 1) {
+		// Idle : Take the timer from the receiver and start
+		pinMode(TIMER_PWM_PIN, OUTPUT);
+		digitalWrite(TIMER_PWM_PIN, LOW);
+		TIMER_DISABLE_INTR;
+#if IR_RECV_SHARED
+		irparams.lent   = true;  // Until the queue empties
+		irparams.clocks = 0;
+#endif
+		irsendparams.index = 0;
+		IRsendNext();
+		if (irsendparams.head != irsendparams.tail)  TIMER_ENABLE_INTR ;
+	}
+	SREG = sreg;
+
+	return ticket;
+}
+
+//+=============================================================================
+int  IRsend::sendRawAsync (const unsigned int buf[],  uint8_t len,  uint8_t khz)
+{
+	return IRsendQueue(buf, NULL, len, khz, false);
+}
+
+int  IRsend::sendRawAsync_P (const unsigned int *buf_P,  uint8_t len,  uint8_t khz)
+{
+	return IRsendQueue(buf_P, NULL, len, khz, true);
+}
+
+int  IRsend::sendAsync (IRencoder *enc)
+{
+	return IRsendQueue(NULL, enc, 0, enc->khz, false);
+}
+
+//+=============================================================================
+// Where a frame has got to; Ask within 128 frames of queueing it
+//
+uint8_t  IRsend::sendStatus (uint8_t ticket)
+{
+	uint8_t  tail = irsendparams.tail;
+
+	if ((int8_t)(ticket - tail) < 0)       return IR_SEND_DONE ;
+	if ((ticket == tail) && sendBusy())     return IR_SEND_SENDING ;
+	return IR_SEND_QUEUED;
+}
+
+bool  IRsend::sendBusy ( )
+{
+	return irsendparams.head != irsendparams.tail;
+}
+
+//+=============================================================================
+// Relaying [see IRrecv::relay()] : A captured slot, read as it is sent
+// Durations are rawbuf[1] on, in ticks; The gap in rawbuf[0] is not sent.
+//
+class IRslotEncoder : public IRencoder
+{
+	public:
+		uint8_t  slot;  // In irparams.slot[]
+		uint8_t  i;     // rawbuf[] index given last
+
+		bool  next (unsigned long *usec) ;
+		void  sent ( ) ;
+};
+
+static IRslotEncoder  relayed[IR_CAPTURE_SLOTS];
+
+bool  IRslotEncoder::next (unsigned long *usec)
+{
+	volatile irslot_t  *s = &irparams.slot[slot];
+	unsigned int        ticks;
+
+	if (s->overflow || (i + 1 >= s->rawlen))  return false ;  // Only whole frames are sent
+	i++;
+
+#if IR_COMPACT_RAWBUF
+	ticks = (s->rawbuf[i] < IR_RAW_ESCAPE) ? s->rawbuf[i] : s->rawlong[s->rawbuf[i] - IR_RAW_ESCAPE];
+#else
+	ticks = s->rawbuf[i];
+#endif
+	*usec = (unsigned long)ticks * USECPERTICK;
+
+	// MARKs are captured long and SPACEs short by the detector's lag
+	if (irsendparams.excess) {
+		if (!(i & 1))                *usec += MARK_EXCESS ;
+		else if (*usec > MARK_EXCESS)  *usec -= MARK_EXCESS ;
+		else                         *usec  = 0 ;
+	}
+	return true;
+}
+
+// Out : Release the slot, as resume() would [it does nothing while relaying]
+void  IRslotEncoder::sent ( )
+{
+	irsendparams.relayed--;
+	irparams.tail++;
+	if (irparams.rcvstate == STATE_STOP)  irparams.rcvstate = STATE_IDLE ;
+}
+
+//+=============================================================================
+// The receiver has just completed slot head - 1 : Queue it
+//
+bool  IRrelaySlot ( )
+{
+	uint8_t         n   = IR_SLOT(irparams.head - 1);
+	IRslotEncoder  *enc = &relayed[n];
+
+	enc->khz  = irsendparams.relay;
+	enc->slot = n;
+	enc->i    = 0;
+
+	irsendparams.relayed++;
+	if (IRsendQueue(NULL, enc, 0, enc->khz, false) < 0) {
+		irsendparams.relayed--;
+		return false;
+	}
+	return true;
+}
+#endif // IR_SEND_ASYNC
@@ -25,72 +25,53 @@
 
 //+=============================================================================
 #if SEND_AIWA_RC_T501
+const irencoding_t  aiwaEncoding PROGMEM = {
+	{AIWA_RC_T501_HDR_MARK, AIWA_RC_T501_HDR_SPACE},  0,
+	{AIWA_RC_T501_BIT_MARK, AIWA_RC_T501_ONE_SPACE},  {AIWA_RC_T501_BIT_MARK, AIWA_RC_T501_ZERO_SPACE},  {AIWA_RC_T501_BIT_MARK, 0},
+	0, 0, AIWA_RC_T501_HZ, 0, 0, 0
+};
+
 void  IRsend::sendAiwaRCT501 (int code)
 {
 	unsigned long  pre = 0x0227EEC0;  // 26-bits
-
-	// Set IR carrier frequency
-	enableIROut(AIWA_RC_T501_HZ);
-
-	// Header
-	mark(AIWA_RC_T501_HDR_MARK);
-	space(AIWA_RC_T501_HDR_SPACE);
-
-	// Send "pre" data
-	for (unsigned long  mask = 1UL << (26 - 1);  mask;  mask >>= 1) {
-		mark(AIWA_RC_T501_BIT_MARK);
-		if (pre & mask)  space(AIWA_RC_T501_ONE_SPACE) ;
-		else             space(AIWA_RC_T501_ZERO_SPACE) ;
-	}
-
-//-v- THIS CODE LOOKS LIKE IT MIGHT BE WRONG - CHECK!
-//    it only send 15bits and ignores the top bit
-//    then uses TOPBIT which is 0x80000000 to check the bit code
-//    I suspect TOPBIT should be changed to 0x00008000
-
-	// Skip first code bit
-	code <<= 1;
-	// Send code
-	for (int  i = 0;  i < 15;  i++) {
-		mark(AIWA_RC_T501_BIT_MARK);
-		if (code & 0x80000000)  space(AIWA_RC_T501_ONE_SPACE) ;
-		else                    space(AIWA_RC_T501_ZERO_SPACE) ;
-		code <<= 1;
-	}
-
-//-^- THIS CODE LOOKS LIKE IT MIGHT BE WRONG - CHECK!
-
-	// POST-DATA, 1 bit, 0x0
-	mark(AIWA_RC_T501_BIT_MARK);
-	space(AIWA_RC_T501_ZERO_SPACE);
-
-	mark(AIWA_RC_T501_BIT_MARK);
-	space(0);
+	IRbitEncoder   enc;
+
+	// The "pre" data, then the low 15 bits of code [as an AVR always sent
+	// them], then the post data : 1 bit, 0x0
+	enc.begin(&aiwaEncoding, pre, AIWA_RC_T501_PRE_BITS,
+	          ((unsigned long)code & 0x7FFF) << AIWA_RC_T501_POST_BITS,
+	          AIWA_RC_T501_BITS + AIWA_RC_T501_POST_BITS);
+	send(&enc);
 }
 #endif
 
 //+=============================================================================
 #if DECODE_AIWA_RC_T501
+// Header signature
+const irsig_t  aiwaSignature PROGMEM = {
+	AIWA_RC_T501, MARK_TICKS(AIWA_RC_T501_HDR_MARK), SPACE_TICKS(AIWA_RC_T501_HDR_SPACE), NULL
+};
+
 bool  IRrecv::decodeAiwaRCT501 (decode_results *results)
 {
 	int  data   = 0;
 	int  offset = 1;
 
 	// Check SIZE
-	if (irparams.rawlen < 2 * (AIWA_RC_T501_SUM_BITS) + 4)  return false ;
+	if (results->rawlen < 2 * (AIWA_RC_T501_SUM_BITS) + 4)  return false ;
 
 	// Check HDR Mark/Space
-	if (!MATCH_MARK (results->rawbuf[offset++], AIWA_RC_T501_HDR_MARK ))  return false ;
-	if (!MATCH_SPACE(results->rawbuf[offset++], AIWA_RC_T501_HDR_SPACE))  return false ;
+	if (!MATCH_MARK (results->rawAt(offset++), AIWA_RC_T501_HDR_MARK ))  return false ;
+	if (!MATCH_SPACE(results->rawAt(offset++), AIWA_RC_T501_HDR_SPACE))  return false ;
 
 	offset += 26;  // skip pre-data - optional
-	while(offset < irparams.rawlen - 4) {
-		if (MATCH_MARK(results->rawbuf[offset], AIWA_RC_T501_BIT_MARK))  offset++ ;
+	while(offset < results->rawlen - 4) {
+		if (MATCH_MARK(results->rawAt(offset), AIWA_RC_T501_BIT_MARK))  offset++ ;
 		else                                                             return false ;
 
 		// ONE & ZERO
-		if      (MATCH_SPACE(results->rawbuf[offset], AIWA_RC_T501_ONE_SPACE))   data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], AIWA_RC_T501_ZERO_SPACE))  data = (data << 1) | 0 ;
+		if      (MATCH_SPACE(results->rawAt(offset), AIWA_RC_T501_ONE_SPACE))   data = (data << 1) | 1 ;
+		else if (MATCH_SPACE(results->rawAt(offset), AIWA_RC_T501_ZERO_SPACE))  data = (data << 1) | 0 ;
 		else                                                                     break ;  // End of one & zero detected
 		offset++;
 	}
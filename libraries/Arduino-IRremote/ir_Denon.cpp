@@ -31,64 +31,39 @@
 //+=============================================================================
 //
 #if SEND_DENON
+const irencoding_t  denonEncoding PROGMEM = {
+	{HDR_MARK, HDR_SPACE},  0,
+	{BIT_MARK, ONE_SPACE},  {BIT_MARK, ZERO_SPACE},  {BIT_MARK, 0},
+	0, 0, 38, 0, 0, 0
+};
+
 void  IRsend::sendDenon (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Header
-	mark (HDR_MARK);
-	space(HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark (BIT_MARK);
-			space(ONE_SPACE);
-		} else {
-			mark (BIT_MARK);
-			space(ZERO_SPACE);
-		}
-	}
+	IRbitEncoder  enc;
 
-	// Footer
-	mark(BIT_MARK);
-    space(0);  // Always end with the LED off
+	enc.begin(&denonEncoding, data, nbits);
+	send(&enc);
 }
 #endif
 
 //+=============================================================================
 //
 #if DECODE_DENON
+// Each bit looks like: MARK + SPACE_1 -> 1
+//                 or : MARK + SPACE_0 -> 0
+static const irpulse_t  denonProtocol PROGMEM = {
+	MARK_TICKS(HDR_MARK), SPACE_TICKS(HDR_SPACE), NO_TICKS,
+	MARK_TICKS(BIT_MARK), SPACE_TICKS(ONE_SPACE), SPACE_TICKS(ZERO_SPACE),
+	BITS, IR_PD_EXACT, DENON
+};
+
+// Header signature
+const irsig_t  denonSignature PROGMEM = {
+	DENON, MARK_TICKS(HDR_MARK), SPACE_TICKS(HDR_SPACE), &denonProtocol
+};
+
 bool  IRrecv::decodeDenon (decode_results *results)
 {
-	unsigned long  data   = 0;  // Somewhere to build our code
-	int            offset = 1;  // Skip the Gap reading
-
-	// Check we have the right amount of data
-	if (irparams.rawlen != 1 + 2 + (2 * BITS) + 1)  return false ;
-
-	// Check initial Mark+Space match
-	if (!MATCH_MARK (results->rawbuf[offset++], HDR_MARK ))  return false ;
-	if (!MATCH_SPACE(results->rawbuf[offset++], HDR_SPACE))  return false ;
-
-	// Read the bits in
-	for (int i = 0;  i < BITS;  i++) {
-		// Each bit looks like: MARK + SPACE_1 -> 1
-		//                 or : MARK + SPACE_0 -> 0
-		if (!MATCH_MARK(results->rawbuf[offset++], BIT_MARK))  return false ;
-
-		// IR data is big-endian, so we shuffle it in from the right:
-		if      (MATCH_SPACE(results->rawbuf[offset], ONE_SPACE))   data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                        return false ;
-		offset++;
-	}
-
-	// Success
-	results->bits        = BITS;
-	results->value       = data;
-	results->decode_type = DENON;
-	return true;
+	return decodePulseDistance(results, &denonProtocol, 1);
 }
 #endif
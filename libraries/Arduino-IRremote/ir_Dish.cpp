@@ -31,24 +31,19 @@
 
 //+=============================================================================
 #if SEND_DISH
+// The last mark added 26th March 2016, by AnalysIR ( https://www.AnalysIR.com )
+const irencoding_t  dishEncoding PROGMEM = {
+	{DISH_HDR_MARK, DISH_HDR_SPACE},  0,
+	{DISH_BIT_MARK, DISH_ONE_SPACE},  {DISH_BIT_MARK, DISH_ZERO_SPACE},  {DISH_HDR_MARK, 0},
+	0, 0, 56, 0, 0, 0
+};
+
 void  IRsend::sendDISH (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(56);
-
-	mark(DISH_HDR_MARK);
-	space(DISH_HDR_SPACE);
+	IRbitEncoder  enc;
 
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(DISH_BIT_MARK);
-			space(DISH_ONE_SPACE);
-		} else {
-			mark(DISH_BIT_MARK);
-			space(DISH_ZERO_SPACE);
-		}
-	}
-	mark(DISH_HDR_MARK); //added 26th March 2016, by AnalysIR ( https://www.AnalysIR.com )
+	enc.begin(&dishEncoding, data, nbits);
+	send(&enc);
 }
 #endif
 
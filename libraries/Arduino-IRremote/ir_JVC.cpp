@@ -24,78 +24,39 @@
 //   and set 'repeat' to true
 //
 #if SEND_JVC
+const irencoding_t  jvcEncoding PROGMEM = {
+	{JVC_HDR_MARK, JVC_HDR_SPACE},  0,
+	{JVC_BIT_MARK, JVC_ONE_SPACE},  {JVC_BIT_MARK, JVC_ZERO_SPACE},  {JVC_BIT_MARK, 0},
+	0, JVC_RPT_LENGTH, 38, 0, 0, IR_ENC_RPT_NOHDR
+};
+
 void  IRsend::sendJVC (unsigned long data,  int nbits,  bool repeat)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Only send the Header if this is NOT a repeat command
-	if (!repeat){
-		mark(JVC_HDR_MARK);
-		space(JVC_HDR_SPACE);
-	}
+	IRbitEncoder  enc;
 
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(JVC_BIT_MARK);
-			space(JVC_ONE_SPACE);
-		} else {
-			mark(JVC_BIT_MARK);
-			space(JVC_ZERO_SPACE);
-		}
-	}
-
-	// Footer
-    mark(JVC_BIT_MARK);
-    space(0);  // Always end with the LED off
+	enc.begin(&jvcEncoding, data, nbits, repeat ? 0 : 1);  // 0 : Only a repeat
+	send(&enc);
 }
 #endif
 
 //+=============================================================================
 #if DECODE_JVC
+// JVC repeats by sending the bits again without the header
+// Exact length, so a longer LG frame [same header] is never taken for JVC
+static const irpulse_t  jvcProtocol PROGMEM = {
+	MARK_TICKS(JVC_HDR_MARK), SPACE_TICKS(JVC_HDR_SPACE), NO_TICKS,
+	MARK_TICKS(JVC_BIT_MARK), SPACE_TICKS(JVC_ONE_SPACE), SPACE_TICKS(JVC_ZERO_SPACE),
+	JVC_BITS, IR_PD_STOP | IR_PD_EXACT | IR_PD_RPT_NOHDR, JVC
+};
+
+// Header signature [A header, or the first bit of a repeat]
+const irsig_t  jvcSignature PROGMEM = {
+	JVC, MARK_RANGE(JVC_BIT_MARK, JVC_HDR_MARK), SPACE_RANGE(JVC_ZERO_SPACE, JVC_HDR_SPACE), &jvcProtocol
+};
+
 bool  IRrecv::decodeJVC (decode_results *results)
 {
-	long  data   = 0;
-	int   offset = 1; // Skip first space
-
-	// Check for repeat
-	if (  (irparams.rawlen - 1 == 33)
-	    && MATCH_MARK(results->rawbuf[offset], JVC_BIT_MARK)
-	    && MATCH_MARK(results->rawbuf[irparams.rawlen-1], JVC_BIT_MARK)
-	   ) {
-		results->bits        = 0;
-		results->value       = REPEAT;
-		results->decode_type = JVC;
-		return true;
-	}
-
-	// Initial mark
-	if (!MATCH_MARK(results->rawbuf[offset++], JVC_HDR_MARK))  return false ;
-
-	if (irparams.rawlen < (2 * JVC_BITS) + 1 )  return false ;
-
-	// Initial space
-	if (!MATCH_SPACE(results->rawbuf[offset++], JVC_HDR_SPACE))  return false ;
-
-	for (int i = 0;  i < JVC_BITS;  i++) {
-		if (!MATCH_MARK(results->rawbuf[offset++], JVC_BIT_MARK))  return false ;
-
-		if      (MATCH_SPACE(results->rawbuf[offset], JVC_ONE_SPACE))   data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], JVC_ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                            return false ;
-		offset++;
-	}
-
-	// Stop bit
-	if (!MATCH_MARK(results->rawbuf[offset], JVC_BIT_MARK))  return false ;
-
-	// Success
-	results->bits        = JVC_BITS;
-	results->value       = data;
-	results->decode_type = JVC;
-
-	return true;
+	return decodePulseDistance(results, &jvcProtocol, 1);
 }
 #endif
 
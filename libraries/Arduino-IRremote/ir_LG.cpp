@@ -20,61 +20,41 @@
 
 //+=============================================================================
 #if DECODE_LG
+static const irpulse_t  lgProtocol PROGMEM = {
+	MARK_TICKS(LG_HDR_MARK), SPACE_TICKS(LG_HDR_SPACE), NO_TICKS,
+	MARK_TICKS(LG_BIT_MARK), SPACE_TICKS(LG_ONE_SPACE), SPACE_TICKS(LG_ZERO_SPACE),
+	LG_BITS, IR_PD_STOP, LG
+};
+
+// Header signature
+const irsig_t  lgSignature PROGMEM = {
+	LG, MARK_TICKS(LG_HDR_MARK), SPACE_TICKS(LG_HDR_SPACE), &lgProtocol
+};
+
+// Exact length, so a longer NEC frame [its header fits too] is never taken for
+// LG when LG decoded last.  Not IR_PD_EXACT : The ISR could no longer stream it.
+//
 bool  IRrecv::decodeLG (decode_results *results)
 {
-    long  data   = 0;
-    int   offset = 1; // Skip first space
-
-	// Check we have the right amount of data
-    if (irparams.rawlen < (2 * LG_BITS) + 1 )  return false ;
-
-    // Initial mark/space
-    if (!MATCH_MARK(results->rawbuf[offset++], LG_HDR_MARK))  return false ;
-    if (!MATCH_SPACE(results->rawbuf[offset++], LG_HDR_SPACE))  return false ;
-
-    for (int i = 0;  i < LG_BITS;  i++) {
-        if (!MATCH_MARK(results->rawbuf[offset++], LG_BIT_MARK))  return false ;
-
-        if      (MATCH_SPACE(results->rawbuf[offset], LG_ONE_SPACE))   data = (data << 1) | 1 ;
-        else if (MATCH_SPACE(results->rawbuf[offset], LG_ZERO_SPACE))  data = (data << 1) | 0 ;
-        else                                                           return false ;
-        offset++;
-    }
-
-    // Stop bit
-    if (!MATCH_MARK(results->rawbuf[offset], LG_BIT_MARK))   return false ;
-
-    // Success
-    results->bits        = LG_BITS;
-    results->value       = data;
-    results->decode_type = LG;
-    return true;
+	if (results->rawlen != 1 + 2 + (2 * LG_BITS) + 1)  return false ;  // gap + header + bits + the MARK that ends it
+	return decodePulseDistance(results, &lgProtocol, 1);
 }
 #endif
 
 //+=============================================================================
 #if SEND_LG
+const irencoding_t  lgEncoding PROGMEM = {
+	{LG_HDR_MARK, LG_HDR_SPACE},  0,
+	{LG_BIT_MARK, LG_ONE_SPACE},  {LG_BIT_MARK, LG_ZERO_SPACE},  {LG_BIT_MARK, 0},
+	0, LG_RPT_LENGTH, 38, 0, 0, 0
+};
+
 void  IRsend::sendLG (unsigned long data,  int nbits)
 {
-    // Set IR carrier frequency
-    enableIROut(38);
-
-    // Header
-    mark(LG_HDR_MARK);
-    space(LG_HDR_SPACE);
-    mark(LG_BIT_MARK);
+	IRbitEncoder  enc;
 
-    // Data
-    for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-        if (data & mask) {
-            space(LG_ONE_SPACE);
-            mark(LG_BIT_MARK);
-        } else {
-            space(LG_ZERO_SPACE);
-            mark(LG_BIT_MARK);
-        }
-    }
-    space(0);  // Always end with the LED off
+	enc.begin(&lgEncoding, data, nbits);
+	send(&enc);
 }
 #endif
 
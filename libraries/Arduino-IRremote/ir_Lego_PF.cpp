@@ -34,13 +34,9 @@ void IRsend::sendLegoPowerFunctions(uint16_t data, bool repeat)
   ::logFunctionParameters(data, repeat);
 #endif // DEBUG
 
-  enableIROut(38);
   static LegoPfBitStreamEncoder bitStreamEncoder;
   bitStreamEncoder.reset(data, repeat);
-  do {
-    mark(bitStreamEncoder.getMarkDuration());
-    space(bitStreamEncoder.getPauseDuration());
-  } while (bitStreamEncoder.next());
+  send(&bitStreamEncoder);
 }
 
 #endif // SEND_LEGO_PF
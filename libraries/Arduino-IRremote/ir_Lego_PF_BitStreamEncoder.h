@@ -1,4 +1,6 @@
 
+#include "IRremote.h"
+
 //==============================================================================
 //    L       EEEEEE   EEEE    OOOO
 //    L       E       E       O    O
@@ -10,13 +12,15 @@
 //+=============================================================================
 //
 
-class LegoPfBitStreamEncoder {
+class LegoPfBitStreamEncoder : public IRencoder {
  private:
   uint16_t data;
   bool repeatMessage;
   uint8_t messageBitIdx;
   uint8_t repeatCount;
   uint16_t messageLength;
+  bool inPause;
+  bool done;
 
  public:
   // HIGH data bit = IR mark + high pause
@@ -39,6 +43,9 @@ class LegoPfBitStreamEncoder {
     messageBitIdx = 0;
     repeatCount = 0;
     messageLength = getMessageLength();
+    khz = 38;
+    inPause = false;
+    done = false;
   }
 
   int getChannelId() const { return 1 + ((data >> 12) & 0x3); }
@@ -75,6 +82,19 @@ class LegoPfBitStreamEncoder {
     }
   }
 
+  // IRencoder: the mark and the pause of each bit in turn
+  bool next(unsigned long *usec) {
+    if (done) return false;
+    if (!inPause) {
+      *usec = getMarkDuration();
+    } else {
+      *usec = getPauseDuration();
+      done = !next();
+    }
+    inPause = !inPause;
+    return true;
+  }
+
   uint8_t getMarkDuration() const { return IR_MARK_DURATION; }
 
   uint32_t getPauseDuration() const {
@@ -24,25 +24,30 @@
 
 //+=============================================================================
 #if DECODE_MITSUBISHI
+// Header signature [Matched the way decodeMitsubishi() does]
+const irsig_t  mitsubishiSignature PROGMEM = {
+	MITSUBISHI, MARK_TICKS(MITSUBISHI_HDR_SPACE), MARK_RANGE(MITSUBISHI_ZERO_MARK, MITSUBISHI_ONE_MARK), NULL
+};
+
 bool  IRrecv::decodeMitsubishi (decode_results *results)
 {
-  // Serial.print("?!? decoding Mitsubishi:");Serial.print(irparams.rawlen); Serial.print(" want "); Serial.println( 2 * MITSUBISHI_BITS + 2);
+  // Serial.print("?!? decoding Mitsubishi:");Serial.print(results->rawlen); Serial.print(" want "); Serial.println( 2 * MITSUBISHI_BITS + 2);
   long data = 0;
-  if (irparams.rawlen < 2 * MITSUBISHI_BITS + 2)  return false ;
+  if (results->rawlen < 2 * MITSUBISHI_BITS + 2)  return false ;
   int offset = 0; // Skip first space
   // Initial space
 
 #if 0
   // Put this back in for debugging - note can't use #DEBUG as if Debug on we don't see the repeat cos of the delay
   Serial.print("IR Gap: ");
-  Serial.println( results->rawbuf[offset]);
+  Serial.println( results->rawAt(offset));
   Serial.println( "test against:");
-  Serial.println(results->rawbuf[offset]);
+  Serial.println(results->rawAt(offset));
 #endif
 
 #if 0
   // Not seeing double keys from Mitsubishi
-  if (results->rawbuf[offset] < MITSUBISHI_DOUBLE_SPACE_USECS) {
+  if (results->rawAt(offset) < MITSUBISHI_DOUBLE_SPACE_USECS) {
     // Serial.print("IR Gap found: ");
     results->bits = 0;
     results->value = REPEAT;
@@ -57,16 +62,16 @@ bool  IRrecv::decodeMitsubishi (decode_results *results)
   // 14200 7 41 7 42 7 42 7 17 7 17 7 18 7 41 7 18 7 17 7 17 7 18 7 41 8 17 7 17 7 18 7 17 7
 
   // Initial Space
-  if (!MATCH_MARK(results->rawbuf[offset], MITSUBISHI_HDR_SPACE))  return false ;
+  if (!MATCH_MARK(results->rawAt(offset), MITSUBISHI_HDR_SPACE))  return false ;
   offset++;
 
-  while (offset + 1 < irparams.rawlen) {
-    if      (MATCH_MARK(results->rawbuf[offset], MITSUBISHI_ONE_MARK))   data = (data << 1) | 1 ;
-    else if (MATCH_MARK(results->rawbuf[offset], MITSUBISHI_ZERO_MARK))  data <<= 1 ;
+  while (offset + 1 < results->rawlen) {
+    if      (MATCH_MARK(results->rawAt(offset), MITSUBISHI_ONE_MARK))   data = (data << 1) | 1 ;
+    else if (MATCH_MARK(results->rawAt(offset), MITSUBISHI_ZERO_MARK))  data <<= 1 ;
     else                                                                 return false ;
     offset++;
 
-    if (!MATCH_SPACE(results->rawbuf[offset], MITSUBISHI_HDR_SPACE))  break ;
+    if (!MATCH_SPACE(results->rawAt(offset), MITSUBISHI_HDR_SPACE))  break ;
     offset++;
   }
 
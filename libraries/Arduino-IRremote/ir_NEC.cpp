@@ -16,32 +16,22 @@
 #define NEC_ONE_SPACE   1690
 #define NEC_ZERO_SPACE   560
 #define NEC_RPT_SPACE   2250
+#define NEC_RPT_LENGTH 108000
 
 //+=============================================================================
 #if SEND_NEC
+const irencoding_t  necEncoding PROGMEM = {
+	{NEC_HDR_MARK, NEC_HDR_SPACE},  NEC_RPT_SPACE,
+	{NEC_BIT_MARK, NEC_ONE_SPACE},  {NEC_BIT_MARK, NEC_ZERO_SPACE},  {NEC_BIT_MARK, 0},
+	0, NEC_RPT_LENGTH, 38, 0, 0, 0
+};
+
 void  IRsend::sendNEC (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Header
-	mark(NEC_HDR_MARK);
-	space(NEC_HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(NEC_BIT_MARK);
-			space(NEC_ONE_SPACE);
-		} else {
-			mark(NEC_BIT_MARK);
-			space(NEC_ZERO_SPACE);
-		}
-	}
+	IRbitEncoder  enc;
 
-	// Footer
-	mark(NEC_BIT_MARK);
-	space(0);  // Always end with the LED off
+	enc.begin(&necEncoding, data, nbits);
+	send(&enc);
 }
 #endif
 
@@ -49,50 +39,19 @@ void  IRsend::sendNEC (unsigned long data,  int nbits)
 // NECs have a repeat only 4 items long
 //
 #if DECODE_NEC
-bool  IRrecv::decodeNEC (decode_results *results)
-{
-	long  data   = 0;  // We decode in to here; Start with nothing
-	int   offset = 1;  // Index in to results; Skip first entry!?
-
-	// Check header "mark"
-	if (!MATCH_MARK(results->rawbuf[offset], NEC_HDR_MARK))  return false ;
-	offset++;
+static const irpulse_t  necProtocol PROGMEM = {
+	MARK_TICKS(NEC_HDR_MARK), SPACE_TICKS(NEC_HDR_SPACE), SPACE_TICKS(NEC_RPT_SPACE),
+	MARK_TICKS(NEC_BIT_MARK), SPACE_TICKS(NEC_ONE_SPACE), SPACE_TICKS(NEC_ZERO_SPACE),
+	NEC_BITS, 0, NEC
+};
 
-	// Check for repeat
-	if ( (irparams.rawlen == 4)
-	    && MATCH_SPACE(results->rawbuf[offset  ], NEC_RPT_SPACE)
-	    && MATCH_MARK (results->rawbuf[offset+1], NEC_BIT_MARK )
-	   ) {
-		results->bits        = 0;
-		results->value       = REPEAT;
-		results->decode_type = NEC;
-		return true;
-	}
+// Header signature
+const irsig_t  necSignature PROGMEM = {
+	NEC, MARK_TICKS(NEC_HDR_MARK), SPACE_RANGE(NEC_RPT_SPACE, NEC_HDR_SPACE), &necProtocol
+};
 
-	// Check we have enough data
-	if (irparams.rawlen < (2 * NEC_BITS) + 4)  return false ;
-
-	// Check header "space"
-	if (!MATCH_SPACE(results->rawbuf[offset], NEC_HDR_SPACE))  return false ;
-	offset++;
-
-	// Build the data
-	for (int i = 0;  i < NEC_BITS;  i++) {
-		// Check data "mark"
-		if (!MATCH_MARK(results->rawbuf[offset], NEC_BIT_MARK))  return false ;
-		offset++;
-        // Suppend this bit
-		if      (MATCH_SPACE(results->rawbuf[offset], NEC_ONE_SPACE ))  data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], NEC_ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                            return false ;
-		offset++;
-	}
-
-	// Success
-	results->bits        = NEC_BITS;
-	results->value       = data;
-	results->decode_type = NEC;
-
-	return true;
+bool  IRrecv::decodeNEC (decode_results *results)
+{
+	return decodePulseDistance(results, &necProtocol, 1);
 }
 #endif
@@ -18,61 +18,38 @@
 
 //+=============================================================================
 #if SEND_PANASONIC
+const irencoding_t  panasonicEncoding PROGMEM = {
+	{PANASONIC_HDR_MARK, PANASONIC_HDR_SPACE},  0,
+	{PANASONIC_BIT_MARK, PANASONIC_ONE_SPACE},  {PANASONIC_BIT_MARK, PANASONIC_ZERO_SPACE},  {PANASONIC_BIT_MARK, 0},
+	0, 0, 35, 0, 0, 0
+};
+
 void  IRsend::sendPanasonic (unsigned int address,  unsigned long data)
 {
-	// Set IR carrier frequency
-	enableIROut(35);
-
-	// Header
-	mark(PANASONIC_HDR_MARK);
-	space(PANASONIC_HDR_SPACE);
-
-	// Address
-	for (unsigned long  mask = 1UL << (16 - 1);  mask;  mask >>= 1) {
-		mark(PANASONIC_BIT_MARK);
-		if (address & mask)  space(PANASONIC_ONE_SPACE) ;
-		else                 space(PANASONIC_ZERO_SPACE) ;
-    }
+	IRbitEncoder  enc;
 
-	// Data
-	for (unsigned long  mask = 1UL << (32 - 1);  mask;  mask >>= 1) {
-        mark(PANASONIC_BIT_MARK);
-        if (data & mask)  space(PANASONIC_ONE_SPACE) ;
-        else              space(PANASONIC_ZERO_SPACE) ;
-    }
-
-	// Footer
-    mark(PANASONIC_BIT_MARK);
-    space(0);  // Always end with the LED off
+	enc.begin(&panasonicEncoding, address, 16, data, 32);
+	send(&enc);
 }
 #endif
 
 //+=============================================================================
 #if DECODE_PANASONIC
+// The 16 address bits come first; decodePulseDistance() leaves them in 'address'
+static const irpulse_t  panasonicProtocol PROGMEM = {
+	MARK_TICKS(PANASONIC_HDR_MARK), SPACE_TICKS(PANASONIC_HDR_SPACE), NO_TICKS,
+	MARK_TICKS(PANASONIC_BIT_MARK), SPACE_TICKS(PANASONIC_ONE_SPACE), SPACE_TICKS(PANASONIC_ZERO_SPACE),
+	PANASONIC_BITS, 0, PANASONIC
+};
+
+// Header signature
+const irsig_t  panasonicSignature PROGMEM = {
+	PANASONIC, MARK_TICKS(PANASONIC_HDR_MARK), SPACE_TICKS(PANASONIC_HDR_SPACE), &panasonicProtocol
+};
+
 bool  IRrecv::decodePanasonic (decode_results *results)
 {
-    unsigned long long  data   = 0;
-    int                 offset = 1;
-
-    if (!MATCH_MARK(results->rawbuf[offset++], PANASONIC_HDR_MARK ))  return false ;
-    if (!MATCH_MARK(results->rawbuf[offset++], PANASONIC_HDR_SPACE))  return false ;
-
-    // decode address
-    for (int i = 0;  i < PANASONIC_BITS;  i++) {
-        if (!MATCH_MARK(results->rawbuf[offset++], PANASONIC_BIT_MARK))  return false ;
-
-        if      (MATCH_SPACE(results->rawbuf[offset],PANASONIC_ONE_SPACE ))  data = (data << 1) | 1 ;
-        else if (MATCH_SPACE(results->rawbuf[offset],PANASONIC_ZERO_SPACE))  data = (data << 1) | 0 ;
-        else                                                                 return false ;
-        offset++;
-    }
-
-    results->value       = (unsigned long)data;
-    results->address     = (unsigned int)(data >> 32);
-    results->decode_type = PANASONIC;
-    results->bits        = PANASONIC_BITS;
-
-    return true;
+	return decodePulseDistance(results, &panasonicProtocol, 1);
 }
 #endif
 
@@ -2,41 +2,88 @@
 #include "IRremoteInt.h"
 
 //+=============================================================================
-// Gets one undecoded level at a time from the raw buffer.
-// The RC5/6 decoding is easier if the data is broken into time intervals.
-// E.g. if the buffer has MARK for 2 time intervals and SPACE for 1,
-// successive calls to getRClevel will return MARK, MARK, SPACE.
-// offset and used are updated to keep track of the current position.
-// t1 is the time interval for a single bit in microseconds.
-// Returns -1 for error (measured time interval is not a multiple of t1).
+// Decode the Manchester bits from rawbuf[offset] to the end, in one pass
+// proto_P : The description, in PROGMEM
+// offset  : Index of the first MARK of the start bits
+//
+// Each MARK or SPACE is matched once, to 1, 2 or 3 halves [T], and the halves
+// are paired in to bits as they come.  A half in the middle of a bit must
+// change level; If not, or a duration is no whole number of halves, it is
+// not this protocol.
+//
+// A start bit whose first half is a SPACE has it lost in the gap, so the
+// frame is read from half way through it.  The last bit's second half is
+// lost in the closing gap if it is a SPACE.
+//
+// More than 32 bits [RC6 mode 6A, MCE]: value holds the last 32, address
+// the ones before them; data has them all [IR_RESULT_BITS].
 //
 #if (DECODE_RC5 || DECODE_RC6)
-int  IRrecv::getRClevel (decode_results *results,  int *offset,  int *used,  int t1)
+bool  IRrecv::decodeManchester (decode_results *results,  const irmanchester_t *proto_P,  int offset)
 {
-	int  width;
-	int  val;
-	int  correction;
-	int  avail;
-
-	if (*offset >= results->rawlen)  return SPACE ;  // After end of recorded buffer, assume SPACE.
-	width      = results->rawbuf[*offset];
-	val        = ((*offset) % 2) ? MARK : SPACE;
-	correction = (val == MARK) ? MARK_EXCESS : - MARK_EXCESS;
-
-	if      (MATCH(width, (  t1) + correction))  avail = 1 ;
-	else if (MATCH(width, (2*t1) + correction))  avail = 2 ;
-	else if (MATCH(width, (3*t1) + correction))  avail = 3 ;
-	else                                         return -1 ;
-
-	(*used)++;
-	if (*used >= avail) {
-		*used = 0;
-		(*offset)++;
-	}
+	irmanchester_t  p;
+	unsigned long   data  = 0;
+	unsigned int    high  = 0;
+	uint8_t         bit   = 0;  // Bits so far, with the start bits
+	uint8_t         need  = 1;  // Units of T in each half of this bit
+	uint8_t         part  = 0;  // Units of this half so far
+	int8_t          first;      // Level of this bit's first half; -1 = At the start of a bit
+
+	memcpy_P(&p, proto_P, sizeof(p));
+
+	first = (offset & 1) ? MARK : SPACE;  // rawbuf[odd] is a MARK
+	first = (first == p.one) ? -1 : p.one ;
+
+	for (;  offset <= results->rawlen;  offset++) {
+		uint8_t  level = (offset & 1) ? MARK : SPACE;
+		uint8_t  units;
 
-	DBG_PRINTLN( (val == MARK) ? "MARK" : "SPACE" );
+		if (offset == results->rawlen) {
+			// The last bit's second half, if a SPACE, is lost in the closing gap
+			if ((first < 0) || (level != SPACE))  break ;
+			units = need;
 
-	return val;
+		} else {
+			const irticks_t  *t    = (level == MARK) ? p.mark : p.space;
+			unsigned int     ticks = results->rawAt(offset);
+
+			if      (MATCH_TICKS(ticks, t[0]))  units = 1 ;
+			else if (MATCH_TICKS(ticks, t[1]))  units = 2 ;
+			else if (MATCH_TICKS(ticks, t[2]))  units = 3 ;
+			else                                return false ;
+		}
+
+		if (part)  return false ;  // A 2T half cut in two
+
+		while (units--) {
+			if (++part < need)  continue ;
+			part = 0;
+
+			if (first < 0) {
+				first = level;
+				continue;
+			}
+			if (first == level)  return false ;  // No change of level mid-bit
+
+			if (bit >= p.start) {
+				high = (high << 1) | (data >> 31);
+				data = (data << 1) | (first == p.one);
+				IR_RESULT_APPEND(results, first == p.one);
+			} else if (first != p.one) {
+				return false;  // Start bits are all 1
+			}
+			first = -1;
+			need  = (++bit == p.wide) ? 2 : 1;
+		}
+	}
+	if ((first >= 0) || part || (bit <= p.start))  return false ;
+
+	// Success
+	if (bit - p.start > 32)  results->address = high ;
+	results->bits        = bit - p.start;
+	results->value       = data;
+	results->decode_type = (decode_type_t)p.type;
+	return true;
 }
 #endif
 
@@ -53,63 +100,44 @@ int  IRrecv::getRClevel (decode_results *results,  int *offset,  int *used,  int
 #define RC5_T1             889
 #define RC5_RPT_LENGTH   46000
 
+#define RC_HALVES_MARK(t1)   { MARK_TICKS(t1),  MARK_TICKS(2 * (t1)),  MARK_TICKS(3 * (t1))  }
+#define RC_HALVES_SPACE(t1)  { SPACE_TICKS(t1), SPACE_TICKS(2 * (t1)), SPACE_TICKS(3 * (t1)) }
+
 //+=============================================================================
 #if SEND_RC5
+// A 1 is SPACE then MARK; Two start bits, the first SPACE lost in the gap
+const irencoding_t  rc5Encoding PROGMEM = {
+	{0},  0,
+	{RC5_T1, RC5_T1},  {RC5_T1, RC5_T1},  {0, 0},
+	0, RC5_RPT_LENGTH, 36, 2, 0, IR_ENC_ONE_SPACE
+};
+
 void  IRsend::sendRC5 (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(36);
-
-	// Start
-	mark(RC5_T1);
-	space(RC5_T1);
-	mark(RC5_T1);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			space(RC5_T1); // 1 is space, then mark
-			mark(RC5_T1);
-		} else {
-			mark(RC5_T1);
-			space(RC5_T1);
-		}
-	}
+	IRbitEncoder  enc;
 
-	space(0);  // Always end with the LED off
+	enc.begin(&rc5Encoding, data, nbits);
+	send(&enc);
 }
 #endif
 
 //+=============================================================================
 #if DECODE_RC5
-bool  IRrecv::decodeRC5 (decode_results *results)
-{
-	int   nbits;
-	long  data   = 0;
-	int   used   = 0;
-	int   offset = 1;  // Skip gap space
-
-	if (irparams.rawlen < MIN_RC5_SAMPLES + 2)  return false ;
+// Header signature [Second half of the first start bit, first half of the second]
+const irsig_t  rc5Signature PROGMEM = {
+	RC5, MARK_TICKS(RC5_T1), SPACE_TICKS(RC5_T1), NULL
+};
 
-	// Get start bits
-	if (getRClevel(results, &offset, &used, RC5_T1) != MARK)   return false ;
-	if (getRClevel(results, &offset, &used, RC5_T1) != SPACE)  return false ;
-	if (getRClevel(results, &offset, &used, RC5_T1) != MARK)   return false ;
+// A 1 is SPACE then MARK; Two start bits
+static const irmanchester_t  rc5Manchester PROGMEM = {
+	RC_HALVES_MARK(RC5_T1), RC_HALVES_SPACE(RC5_T1), SPACE, 2, 0, RC5
+};
 
-	for (nbits = 0;  offset < irparams.rawlen;  nbits++) {
-		int  levelA = getRClevel(results, &offset, &used, RC5_T1);
-		int  levelB = getRClevel(results, &offset, &used, RC5_T1);
-
-		if      ((levelA == SPACE) && (levelB == MARK ))  data = (data << 1) | 1 ;
-		else if ((levelA == MARK ) && (levelB == SPACE))  data = (data << 1) | 0 ;
-		else                                              return false ;
-	}
+bool  IRrecv::decodeRC5 (decode_results *results)
+{
+	if (results->rawlen < MIN_RC5_SAMPLES + 2)  return false ;
 
-	// Success
-	results->bits        = nbits;
-	results->value       = data;
-	results->decode_type = RC5;
-	return true;
+	return decodeManchester(results, &rc5Manchester, 1);  // Skip gap space
 }
 #endif
 
@@ -129,79 +157,46 @@ bool  IRrecv::decodeRC5 (decode_results *results)
 #define RC6_RPT_LENGTH   46000
 
 #if SEND_RC6
+// A 1 is MARK then SPACE; One start bit, then the fourth bit we send is a
+// "double width trailer bit"
+const irencoding_t  rc6Encoding PROGMEM = {
+	{RC6_HDR_MARK, RC6_HDR_SPACE},  0,
+	{RC6_T1, RC6_T1},  {RC6_T1, RC6_T1},  {0, 0},
+	0, RC6_RPT_LENGTH, 36, 1, 4, IR_ENC_ZERO_SPACE
+};
+
 void  IRsend::sendRC6 (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(36);
-
-	// Header
-	mark(RC6_HDR_MARK);
-	space(RC6_HDR_SPACE);
-
-	// Start bit
-	mark(RC6_T1);
-	space(RC6_T1);
-
-	// Data
-	for (unsigned long  i = 1, mask = 1UL << (nbits - 1);  mask;  i++, mask >>= 1) {
-		// The fourth bit we send is a "double width trailer bit"
-		int  t = (i == 4) ? (RC6_T1 * 2) : (RC6_T1) ;
-		if (data & mask) {
-			mark(t);
-			space(t);
-		} else {
-			space(t);
-			mark(t);
-		}
-	}
+	IRbitEncoder  enc;
 
-	space(0);  // Always end with the LED off
+	enc.begin(&rc6Encoding, data, nbits);
+	send(&enc);
 }
 #endif
 
 //+=============================================================================
 #if DECODE_RC6
+// Header signature
+const irsig_t  rc6Signature PROGMEM = {
+	RC6, MARK_TICKS(RC6_HDR_MARK), SPACE_TICKS(RC6_HDR_SPACE), NULL
+};
+
+// A 1 is MARK then SPACE [inverted compared to RC5]; One start bit, then
+// 3 mode bits and the double width trailer bit [bit 4]
+static const irmanchester_t  rc6Manchester PROGMEM = {
+	RC_HALVES_MARK(RC6_T1), RC_HALVES_SPACE(RC6_T1), MARK, 1, 4, RC6
+};
+
 bool  IRrecv::decodeRC6 (decode_results *results)
 {
-	int   nbits;
-	long  data   = 0;
-	int   used   = 0;
-	int   offset = 1;  // Skip first space
+	int  offset = 1;  // Skip first space
 
 	if (results->rawlen < MIN_RC6_SAMPLES)  return false ;
 
 	// Initial mark
-	if (!MATCH_MARK(results->rawbuf[offset++],  RC6_HDR_MARK))   return false ;
-	if (!MATCH_SPACE(results->rawbuf[offset++], RC6_HDR_SPACE))  return false ;
-
-	// Get start bit (1)
-	if (getRClevel(results, &offset, &used, RC6_T1) != MARK)   return false ;
-	if (getRClevel(results, &offset, &used, RC6_T1) != SPACE)  return false ;
-
-	for (nbits = 0;  offset < results->rawlen;  nbits++) {
-		int  levelA, levelB;  // Next two levels
-
-		levelA = getRClevel(results, &offset, &used, RC6_T1);
-		if (nbits == 3) {
-			// T bit is double wide; make sure second half matches
-			if (levelA != getRClevel(results, &offset, &used, RC6_T1)) return false;
-		}
-
-		levelB = getRClevel(results, &offset, &used, RC6_T1);
-		if (nbits == 3) {
-			// T bit is double wide; make sure second half matches
-			if (levelB != getRClevel(results, &offset, &used, RC6_T1)) return false;
-		}
-
-		if      ((levelA == MARK ) && (levelB == SPACE))  data = (data << 1) | 1 ;  // inverted compared to RC5
-		else if ((levelA == SPACE) && (levelB == MARK ))  data = (data << 1) | 0 ;  // ...
-		else                                              return false ;            // Error
-	}
+	if (!MATCH_MARK(results->rawAt(offset++),  RC6_HDR_MARK))   return false ;
+	if (!MATCH_SPACE(results->rawAt(offset++), RC6_HDR_SPACE))  return false ;
 
-	// Success
-	results->bits        = nbits;
-	results->value       = data;
-	results->decode_type = RC6;
-	return true;
+	return decodeManchester(results, &rc6Manchester, offset);
 }
 #endif
@@ -16,32 +16,22 @@
 #define SAMSUNG_ONE_SPACE   1600
 #define SAMSUNG_ZERO_SPACE   560
 #define SAMSUNG_RPT_SPACE   2250
+#define SAMSUNG_RPT_LENGTH 108000
 
 //+=============================================================================
 #if SEND_SAMSUNG
+const irencoding_t  samsungEncoding PROGMEM = {
+	{SAMSUNG_HDR_MARK, SAMSUNG_HDR_SPACE},  SAMSUNG_RPT_SPACE,
+	{SAMSUNG_BIT_MARK, SAMSUNG_ONE_SPACE},  {SAMSUNG_BIT_MARK, SAMSUNG_ZERO_SPACE},  {SAMSUNG_BIT_MARK, 0},
+	0, SAMSUNG_RPT_LENGTH, 38, 0, 0, 0
+};
+
 void  IRsend::sendSAMSUNG (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Header
-	mark(SAMSUNG_HDR_MARK);
-	space(SAMSUNG_HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(SAMSUNG_BIT_MARK);
-			space(SAMSUNG_ONE_SPACE);
-		} else {
-			mark(SAMSUNG_BIT_MARK);
-			space(SAMSUNG_ZERO_SPACE);
-		}
-	}
+	IRbitEncoder  enc;
 
-	// Footer
-	mark(SAMSUNG_BIT_MARK);
-    space(0);  // Always end with the LED off
+	enc.begin(&samsungEncoding, data, nbits);
+	send(&enc);
 }
 #endif
 
@@ -49,44 +39,20 @@ void  IRsend::sendSAMSUNG (unsigned long data,  int nbits)
 // SAMSUNGs have a repeat only 4 items long
 //
 #if DECODE_SAMSUNG
-bool  IRrecv::decodeSAMSUNG (decode_results *results)
-{
-	long  data   = 0;
-	int   offset = 1;  // Skip first space
-
-	// Initial mark
-	if (!MATCH_MARK(results->rawbuf[offset], SAMSUNG_HDR_MARK))   return false ;
-	offset++;
+static const irpulse_t  samsungProtocol PROGMEM = {
+	MARK_TICKS(SAMSUNG_HDR_MARK), SPACE_TICKS(SAMSUNG_HDR_SPACE), SPACE_TICKS(SAMSUNG_RPT_SPACE),
+	MARK_TICKS(SAMSUNG_BIT_MARK), SPACE_TICKS(SAMSUNG_ONE_SPACE), SPACE_TICKS(SAMSUNG_ZERO_SPACE),
+	SAMSUNG_BITS, 0, SAMSUNG
+};
 
-	// Check for repeat
-	if (    (irparams.rawlen == 4)
-	     && MATCH_SPACE(results->rawbuf[offset], SAMSUNG_RPT_SPACE)
-	     && MATCH_MARK(results->rawbuf[offset+1], SAMSUNG_BIT_MARK)
-	   ) {
-		results->bits        = 0;
-		results->value       = REPEAT;
-		results->decode_type = SAMSUNG;
-		return true;
-	}
-	if (irparams.rawlen < (2 * SAMSUNG_BITS) + 4)  return false ;
+// Header signature
+const irsig_t  samsungSignature PROGMEM = {
+	SAMSUNG, MARK_TICKS(SAMSUNG_HDR_MARK), SPACE_RANGE(SAMSUNG_RPT_SPACE, SAMSUNG_HDR_SPACE), &samsungProtocol
+};
 
-	// Initial space
-	if (!MATCH_SPACE(results->rawbuf[offset++], SAMSUNG_HDR_SPACE))  return false ;
-
-	for (int i = 0;  i < SAMSUNG_BITS;   i++) {
-		if (!MATCH_MARK(results->rawbuf[offset++], SAMSUNG_BIT_MARK))  return false ;
-
-		if      (MATCH_SPACE(results->rawbuf[offset], SAMSUNG_ONE_SPACE))   data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], SAMSUNG_ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                                return false ;
-		offset++;
-	}
-
-	// Success
-	results->bits        = SAMSUNG_BITS;
-	results->value       = data;
-	results->decode_type = SAMSUNG;
-	return true;
+bool  IRrecv::decodeSAMSUNG (decode_results *results)
+{
+	return decodePulseDistance(results, &samsungProtocol, 1);
 }
 #endif
 
@@ -22,23 +22,34 @@
 
 //+=============================================================================
 #if DECODE_SANYO
+// Header signature [The header is two marks]
+const irsig_t  sanyoSignature PROGMEM = {
+	SANYO, MARK_TICKS(SANYO_HDR_MARK), MARK_TICKS(SANYO_HDR_MARK), NULL
+};
+
+// Pulse width : Each bit is a SANYO_HDR_SPACE then a ONE or ZERO mark
+static const irpulse_t  sanyoProtocol PROGMEM = {
+	NO_TICKS, NO_TICKS, NO_TICKS,
+	SPACE_TICKS(SANYO_HDR_SPACE), MARK_TICKS(SANYO_ONE_MARK), MARK_TICKS(SANYO_ZERO_MARK),
+	SANYO_BITS, IR_PD_PULSE_WIDTH, SANYO
+};
+
 bool  IRrecv::decodeSanyo (decode_results *results)
 {
-	long  data   = 0;
 	int   offset = 0;  // Skip first space  <-- CHECK THIS!
 
-	if (irparams.rawlen < (2 * SANYO_BITS) + 2)  return false ;
+	if (results->rawlen < (2 * SANYO_BITS) + 2)  return false ;
 
 #if 0
 	// Put this back in for debugging - note can't use #DEBUG as if Debug on we don't see the repeat cos of the delay
 	Serial.print("IR Gap: ");
-	Serial.println( results->rawbuf[offset]);
+	Serial.println( results->rawAt(offset));
 	Serial.println( "test against:");
-	Serial.println(results->rawbuf[offset]);
+	Serial.println(results->rawAt(offset));
 #endif
 
 	// Initial space
-	if (results->rawbuf[offset] < SANYO_DOUBLE_SPACE_USECS) {
+	if (results->rawAt(offset) < SANYO_DOUBLE_SPACE_USECS) {
 		//Serial.print("IR Gap found: ");
 		results->bits        = 0;
 		results->value       = REPEAT;
@@ -48,29 +59,16 @@ bool  IRrecv::decodeSanyo (decode_results *results)
 	offset++;
 
 	// Initial mark
-	if (!MATCH_MARK(results->rawbuf[offset++], SANYO_HDR_MARK))  return false ;
+	if (!MATCH_MARK(results->rawAt(offset++), SANYO_HDR_MARK))  return false ;
 
 	// Skip Second Mark
-	if (!MATCH_MARK(results->rawbuf[offset++], SANYO_HDR_MARK))  return false ;
-
-	while (offset + 1 < irparams.rawlen) {
-		if (!MATCH_SPACE(results->rawbuf[offset++], SANYO_HDR_SPACE))  break ;
+	if (!MATCH_MARK(results->rawAt(offset++), SANYO_HDR_MARK))  return false ;
 
-		if      (MATCH_MARK(results->rawbuf[offset], SANYO_ONE_MARK))   data = (data << 1) | 1 ;
-		else if (MATCH_MARK(results->rawbuf[offset], SANYO_ZERO_MARK))  data = (data << 1) | 0 ;
-		else                                                            return false ;
-		offset++;
-	}
-
-	// Success
-	results->bits = (offset - 1) / 2;
-	if (results->bits < 12) {
-		results->bits = 0;
-		return false;
-	}
+	if (!decodePulseDistance(results, &sanyoProtocol, offset))  return false ;
 
-	results->value       = data;
-	results->decode_type = SANYO;
+	// This decoder has always counted one bit more than the frame has [the
+	// second header mark]; Sketches may match on it, so it still does
+	results->bits++;
 	return true;
 }
 #endif
@@ -33,29 +33,21 @@
 
 //+=============================================================================
 #if SEND_SHARP
+// Each frame ends with a 40mS pause; The next is inverted
+const irencoding_t  sharpEncoding PROGMEM = {
+	{0},  0,
+	{SHARP_BIT_MARK, SHARP_ONE_SPACE},  {SHARP_BIT_MARK, SHARP_ZERO_SPACE},  {SHARP_BIT_MARK, SHARP_ZERO_SPACE + 40000U},
+	SHARP_TOGGLE_MASK, 0, 38, 0, 0, 0
+};
+
 void  IRsend::sendSharpRaw (unsigned long data,  int nbits)
 {
-	enableIROut(38);
+	IRbitEncoder  enc;
 
 	// Sending codes in bursts of 3 (normal, inverted, normal) makes transmission
 	// much more reliable. That's the exact behaviour of CD-S6470 remote control.
-	for (int n = 0;  n < 3;  n++) {
-		for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-			if (data & mask) {
-				mark(SHARP_BIT_MARK);
-				space(SHARP_ONE_SPACE);
-			} else {
-				mark(SHARP_BIT_MARK);
-				space(SHARP_ZERO_SPACE);
-			}
-		}
-
-		mark(SHARP_BIT_MARK);
-		space(SHARP_ZERO_SPACE);
-		delay(40);
-
-		data = data ^ SHARP_TOGGLE_MASK;
-	}
+	enc.begin(&sharpEncoding, data, nbits, 3);
+	send(&enc);
 }
 #endif
 
@@ -19,47 +19,51 @@
 
 //+=============================================================================
 #if SEND_SONY
+// Pulse width : Each bit is a ONE or ZERO mark, then a SONY_HDR_SPACE
+const irencoding_t  sonyEncoding PROGMEM = {
+	{SONY_HDR_MARK, SONY_HDR_SPACE},  0,
+	{SONY_ONE_MARK, SONY_HDR_SPACE},  {SONY_ZERO_MARK, SONY_HDR_SPACE},  {0, 0},
+	0, SONY_RPT_LENGTH, 40, 0, 0, 0
+};
+
 void  IRsend::sendSony (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(40);
-
-	// Header
-	mark(SONY_HDR_MARK);
-	space(SONY_HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(SONY_ONE_MARK);
-			space(SONY_HDR_SPACE);
-		} else {
-			mark(SONY_ZERO_MARK);
-			space(SONY_HDR_SPACE);
-    	}
-  	}
+	IRbitEncoder  enc;
 
-	// We will have ended with LED off
+	enc.begin(&sonyEncoding, data, nbits);
+	send(&enc);
 }
 #endif
 
 //+=============================================================================
 #if DECODE_SONY
+// Header signature
+const irsig_t  sonySignature PROGMEM = {
+	SONY, MARK_TICKS(SONY_HDR_MARK), SPACE_TICKS(SONY_HDR_SPACE), NULL
+};
+
+// Pulse width : Each bit is a SONY_HDR_SPACE then a ONE or ZERO mark
+// 12, 15 and 20 bit frames are all in use
+static const irpulse_t  sonyProtocol PROGMEM = {
+	MARK_TICKS(SONY_HDR_MARK), NO_TICKS, NO_TICKS,
+	SPACE_TICKS(SONY_HDR_SPACE), MARK_TICKS(SONY_ONE_MARK), MARK_TICKS(SONY_ZERO_MARK),
+	SONY_BITS, IR_PD_PULSE_WIDTH, SONY
+};
+
 bool  IRrecv::decodeSony (decode_results *results)
 {
-	long  data   = 0;
 	int   offset = 0;  // Dont skip first space, check its size
 
-	if (irparams.rawlen < (2 * SONY_BITS) + 2)  return false ;
+	if (results->rawlen < (2 * SONY_BITS) + 2)  return false ;
 
 	// Some Sony's deliver repeats fast after first
 	// unfortunately can't spot difference from of repeat from two fast clicks
-	if (results->rawbuf[offset] < SONY_DOUBLE_SPACE_USECS) {
+	if (results->rawAt(offset) < SONY_DOUBLE_SPACE_USECS) {
 		// Serial.print("IR Gap found: ");
 		results->bits = 0;
 		results->value = REPEAT;
 
-#	ifdef DECODE_SANYO
+#	if DECODE_SANYO
 		results->decode_type = SANYO;
 #	else
 		results->decode_type = UNKNOWN;
@@ -69,27 +73,7 @@ bool  IRrecv::decodeSony (decode_results *results)
 	}
 	offset++;
 
-	// Initial mark
-	if (!MATCH_MARK(results->rawbuf[offset++], SONY_HDR_MARK))  return false ;
-
-	while (offset + 1 < irparams.rawlen) {
-		if (!MATCH_SPACE(results->rawbuf[offset++], SONY_HDR_SPACE))  break ;
-
-		if      (MATCH_MARK(results->rawbuf[offset], SONY_ONE_MARK))   data = (data << 1) | 1 ;
-		else if (MATCH_MARK(results->rawbuf[offset], SONY_ZERO_MARK))  data = (data << 1) | 0 ;
-		else                                                           return false ;
-		offset++;
-	}
-
-	// Success
-	results->bits = (offset - 1) / 2;
-	if (results->bits < 12) {
-		results->bits = 0;
-		return false;
-	}
-	results->value       = data;
-	results->decode_type = SONY;
-	return true;
+	return decodePulseDistance(results, &sonyProtocol, offset);
 }
 #endif
 
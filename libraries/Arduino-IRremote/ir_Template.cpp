@@ -54,7 +54,9 @@ Now you must do a few things to add it to the IRremote system:
           void  sendShuzu (unsigned long data,  int nbits) ;
       #endif
 
-   E. Save your changes and close the file
+   E. And add shuzuEncoding to the list of extern const irencoding_t's
+
+   F. Save your changes and close the file
 
 2. Now open irRecv.cpp and make the following change:
 
@@ -116,29 +118,18 @@ Regards,
 //+=============================================================================
 //
 #if SEND_SHUZU
+const irencoding_t  shuzuEncoding PROGMEM = {
+	{HDR_MARK, HDR_SPACE},  0,
+	{BIT_MARK, ONE_SPACE},  {BIT_MARK, ZERO_SPACE},  {BIT_MARK, 0},
+	0, 0, 38, 0, 0, 0
+};
+
 void  IRsend::sendShuzu (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Header
-	mark (HDR_MARK);
-	space(HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark (BIT_MARK);
-			space(ONE_SPACE);
-		} else {
-			mark (BIT_MARK);
-			space(ZERO_SPACE);
-		}
-	}
+	IRbitEncoder  enc;
 
-	// Footer
-	mark(BIT_MARK);
-    space(0);  // Always end with the LED off
+	enc.begin(&shuzuEncoding, data, nbits);
+	send(&enc);
 }
 #endif
 
@@ -151,21 +142,21 @@ bool  IRrecv::decodeShuzu (decode_results *results)
 	int            offset = 1;  // Skip the Gap reading
 
 	// Check we have the right amount of data
-	if (irparams.rawlen != 1 + 2 + (2 * BITS) + 1)  return false ;
+	if (results->rawlen != 1 + 2 + (2 * BITS) + 1)  return false ;
 
 	// Check initial Mark+Space match
-	if (!MATCH_MARK (results->rawbuf[offset++], HDR_MARK ))  return false ;
-	if (!MATCH_SPACE(results->rawbuf[offset++], HDR_SPACE))  return false ;
+	if (!MATCH_MARK (results->rawAt(offset++), HDR_MARK ))  return false ;
+	if (!MATCH_SPACE(results->rawAt(offset++), HDR_SPACE))  return false ;
 
 	// Read the bits in
 	for (int i = 0;  i < SHUZU_BITS;  i++) {
 		// Each bit looks like: MARK + SPACE_1 -> 1
 		//                 or : MARK + SPACE_0 -> 0
-		if (!MATCH_MARK(results->rawbuf[offset++], BIT_MARK))  return false ;
+		if (!MATCH_MARK(results->rawAt(offset++), BIT_MARK))  return false ;
 
 		// IR data is big-endian, so we shuffle it in from the right:
-		if      (MATCH_SPACE(results->rawbuf[offset], ONE_SPACE))   data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], ZERO_SPACE))  data = (data << 1) | 0 ;
+		if      (MATCH_SPACE(results->rawAt(offset), ONE_SPACE))   data = (data << 1) | 1 ;
+		else if (MATCH_SPACE(results->rawAt(offset), ZERO_SPACE))  data = (data << 1) | 0 ;
 		else                                                        return false ;
 		offset++;
 	}
@@ -20,72 +20,42 @@
 
 //+=============================================================================
 #if SEND_WHYNTER
+// The header starts with a lead-in bit [a 0]; The footer ends with a SPACE
+const irencoding_t  whynterEncoding PROGMEM = {
+	{WHYNTER_ZERO_MARK, WHYNTER_ZERO_SPACE, WHYNTER_HDR_MARK, WHYNTER_HDR_SPACE},  0,
+	{WHYNTER_ONE_MARK, WHYNTER_ONE_SPACE},  {WHYNTER_ZERO_MARK, WHYNTER_ZERO_SPACE},  {WHYNTER_ZERO_MARK, WHYNTER_ZERO_SPACE},
+	0, 0, 38, 0, 0, 0
+};
+
 void  IRsend::sendWhynter (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Start
-	mark(WHYNTER_ZERO_MARK);
-	space(WHYNTER_ZERO_SPACE);
-
-	// Header
-	mark(WHYNTER_HDR_MARK);
-	space(WHYNTER_HDR_SPACE);
+	IRbitEncoder  enc;
 
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(WHYNTER_ONE_MARK);
-			space(WHYNTER_ONE_SPACE);
-		} else {
-			mark(WHYNTER_ZERO_MARK);
-			space(WHYNTER_ZERO_SPACE);
-		}
-	}
-
-	// Footer
-	mark(WHYNTER_ZERO_MARK);
-	space(WHYNTER_ZERO_SPACE);  // Always end with the LED off
+	enc.begin(&whynterEncoding, data, nbits);
+	send(&enc);
 }
 #endif
 
 //+=============================================================================
 #if DECODE_WHYNTER
-bool  IRrecv::decodeWhynter (decode_results *results)
-{
-	long  data   = 0;
-	int   offset = 1;  // skip initial space
+// Header signature [The lead-in bit]
+const irsig_t  whynterSignature PROGMEM = {
+	WHYNTER, MARK_TICKS(WHYNTER_BIT_MARK), SPACE_TICKS(WHYNTER_ZERO_SPACE), NULL
+};
 
-	// Check we have the right amount of data
-	if (irparams.rawlen < (2 * WHYNTER_BITS) + 6)  return false ;
+static const irpulse_t  whynterProtocol PROGMEM = {
+	MARK_TICKS(WHYNTER_HDR_MARK), SPACE_TICKS(WHYNTER_HDR_SPACE), NO_TICKS,
+	MARK_TICKS(WHYNTER_BIT_MARK), SPACE_TICKS(WHYNTER_ONE_SPACE), SPACE_TICKS(WHYNTER_ZERO_SPACE),
+	WHYNTER_BITS, IR_PD_STOP, WHYNTER
+};
 
+bool  IRrecv::decodeWhynter (decode_results *results)
+{
 	// Sequence begins with a bit mark and a zero space
-	if (!MATCH_MARK (results->rawbuf[offset++], WHYNTER_BIT_MARK  ))  return false ;
-	if (!MATCH_SPACE(results->rawbuf[offset++], WHYNTER_ZERO_SPACE))  return false ;
-
-	// header mark and space
-	if (!MATCH_MARK (results->rawbuf[offset++], WHYNTER_HDR_MARK ))  return false ;
-	if (!MATCH_SPACE(results->rawbuf[offset++], WHYNTER_HDR_SPACE))  return false ;
-
-	// data bits
-	for (int i = 0;  i < WHYNTER_BITS;  i++) {
-		if (!MATCH_MARK(results->rawbuf[offset++], WHYNTER_BIT_MARK))  return false ;
-
-		if      (MATCH_SPACE(results->rawbuf[offset], WHYNTER_ONE_SPACE ))  data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], WHYNTER_ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                                return false ;
-		offset++;
-	}
-
-	// trailing mark
-	if (!MATCH_MARK(results->rawbuf[offset], WHYNTER_BIT_MARK))  return false ;
+	if (!MATCH_MARK (results->rawAt(1), WHYNTER_BIT_MARK  ))  return false ;
+	if (!MATCH_SPACE(results->rawAt(2), WHYNTER_ZERO_SPACE))  return false ;
 
-	// Success
-	results->bits = WHYNTER_BITS;
-	results->value = data;
-	results->decode_type = WHYNTER;
-	return true;
+	return decodePulseDistance(results, &whynterProtocol, 3);
 }
 #endif
 
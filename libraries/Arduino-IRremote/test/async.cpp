@@ -0,0 +1,128 @@
+//******************************************************************************
+// Async test : Queued frames go out from the timer interrupt, each MARK and
+// SPACE within a carrier period of what was asked [IR_SEND_ASYNC]
+//
+// Four frames are queued at once on the virtual Timer2 of sim.h : From RAM at
+// 38kHz, from PROGMEM at 36kHz, one at 40kHz with a SPACE of 0 [its MARKs run
+// together], and one that ends with a MARK [a _GAP SPACE follows it].  A fifth
+// finds the queue full.  The LED is logged each uS and compared with the
+// frames; sendStatus() and sendBusy() are checked as they go, and the timer
+// interrupt must be off once the queue is empty [the receiver was never
+// enabled].  Prints the worst error of each frame [make async, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+#include "sim.h"
+
+#if !IR_SEND_ASYNC
+#	error "Build it with -DIR_SEND_ASYNC=1"
+#endif
+
+typedef
+	struct {
+		const unsigned int  *usec;
+		uint8_t              len;
+		uint8_t              khz;
+		bool                 progmem;
+	}
+frame_t;
+
+static const unsigned int  ram[]         = {9000, 4500, 560, 1690, 560, 560, 560, 20000};
+static const unsigned int  flash[]       PROGMEM = {889, 889, 1778, 889, 889, 1778, 889, 10000};
+static const unsigned int  zeroSpace[]   = {2400, 600, 1200, 0, 600, 600, 1200, 10000};
+static const unsigned int  endsInMark[]  = {3000, 1000, 500};
+
+static const frame_t  frames[] = {
+	{ram,        sizeof(ram) / sizeof(ram[0]),               38, false},
+	{flash,      sizeof(flash) / sizeof(flash[0]),           36, true },
+	{zeroSpace,  sizeof(zeroSpace) / sizeof(zeroSpace[0]),   40, false},
+	{endsInMark, sizeof(endsInMark) / sizeof(endsInMark[0]), 38, false},
+};
+#define FRAMES  (sizeof(frames) / sizeof(frames[0]))
+
+IRsend  irsend;
+
+//+=============================================================================
+int  main ( )
+{
+	static unsigned long  want[64], got[64];
+	static uint8_t        owner[64];
+	int                   wants = 0, gots, tickets[FRAMES];
+	unsigned long         start;
+	bool                  ok = true;
+
+	simStart();
+	simRun(1000);
+
+	// What the LED should do : Each frame's durations, a SPACE of 0 running its
+	// MARKs together, and a _GAP after one that ends with a MARK
+	for (unsigned int f = 0;  f < FRAMES;  f++) {
+		for (int i = 0;  i < frames[f].len;  i++) {
+			if (!frames[f].usec[i])  continue ;
+			if ((wants & 1) == (i & 1))  { owner[wants] = f;  want[wants++] = 0; }
+			want[wants - 1] += frames[f].usec[i];
+		}
+		if (frames[f].len & 1)  { owner[wants] = f;  want[wants++] = _GAP; }
+	}
+
+	// Queue them all at once, and one too many
+	start = micros();
+	for (unsigned int f = 0;  f < FRAMES;  f++) {
+		tickets[f] = frames[f].progmem ? irsend.sendRawAsync_P(frames[f].usec, frames[f].len, frames[f].khz)
+		                               : irsend.sendRawAsync(frames[f].usec, frames[f].len, frames[f].khz);
+	}
+	if (irsend.sendRawAsync(ram, sizeof(ram) / sizeof(ram[0]), 38) != -1) {
+		printf("A fifth frame was queued, with IR_SEND_QUEUE %d\n", IR_SEND_QUEUE);
+		ok = false;
+	}
+	if ((irsend.sendStatus(tickets[0]) != IR_SEND_SENDING) || (irsend.sendStatus(tickets[1]) != IR_SEND_QUEUED)) {
+		printf("The first frame should be sending, and the next queued\n");
+		ok = false;
+	}
+
+	// Let them go, while loop() would carry on
+	for (unsigned int f = 0;  f < FRAMES;  f++) {
+		unsigned long  len = 0;
+
+		for (int i = 0;  i < frames[f].len;  i++)  len += frames[f].usec[i] ;
+		if (frames[f].len & 1)  len += _GAP ;
+		simRun(len);
+	}
+	simRun(1000);
+
+	if (irsend.sendBusy() || (irsend.sendStatus(tickets[FRAMES - 1]) != IR_SEND_DONE)) {
+		printf("Still sending %lu uS after the frames should have ended\n", micros() - start);
+		ok = false;
+	}
+	if (TIMSK2) {
+		printf("The timer interrupt is still on, and the receiver was never enabled\n");
+		ok = false;
+	}
+
+	// The LED against the frames [the last SPACE never ends : The LED stays off]
+	gots = simWave(0, got, 64);
+	if (gots != wants - 1) {
+		printf("The LED made %d MARKs and SPACEs, not %d\n", gots, wants - 1);
+		ok = false;
+	}
+	for (unsigned int f = 0;  f < FRAMES;  f++) {
+		long  period = 1000 / frames[f].khz;  // uS, rounded down
+		long  worst  = 0;
+
+		for (int i = 0;  (i < gots) && (i < wants - 1);  i++) {
+			long  err = (long)got[i] - (long)want[i];
+
+			if (owner[i] != f)  continue ;
+			if (labs(err) > labs(worst))  worst = err ;
+			if (labs(err) > period) {
+				printf("Frame %u : Duration %d is %lu uS, not %lu\n", f, i, got[i], want[i]);
+				ok = false;
+			}
+		}
+		printf("Frame %u [%2u kHz, %s] : Worst error %+ld uS, a carrier period is %ld uS\n",
+		       f, frames[f].khz, frames[f].progmem ? "PROGMEM" : "RAM    ", worst, period);
+	}
+
+	printf("%s : %lu timer interrupts\n", ok ? "Sent as queued" : "FAILED", simIsrs);
+	return ok ? 0 : 1;
+}
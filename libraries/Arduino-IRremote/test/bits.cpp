@@ -0,0 +1,195 @@
+//******************************************************************************
+// Bits test : decode_results.data holds every bit of a frame, however long,
+// and equals() and hash() tell frames apart by them [IR_RESULT_BITS]
+//
+// Each IRbench capture is decoded with decodeSpan(), and a Panasonic frame
+// with one address bit flipped besides [48 bits, as is the 36 bit MCE one].
+// Every frame must decode as captured, and data must hold the bits of its
+// address and value, the first received first : Only the first IR_RESULT_BITS
+// of them, but counting them all.  Two frames' data must be equal only if
+// they decoded alike, and hash the same if they are.
+// Then the captures that stream [IR_RECV_STREAM] are sent on the virtual
+// Timer2 of sim.h with their protocol locked, and decoded before their gap
+// ends : data must be filled from the ISR's bits just the same.
+// Prints the bits of each frame, and the time per frame decoded on this PC to
+// stderr [make bits, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+#include "sim.h"
+
+#include <time.h>
+
+#if !IR_RECV_STREAM
+#	error "Build it with -DIR_RECV_STREAM=1 : The ISR fills data of streamed frames"
+#endif
+
+typedef
+	struct {
+		int8_t               type;    // What it should decode as
+		unsigned long        value;
+		const unsigned int  *timing;  // uS, as IRrecvDumpV2 prints them
+		uint8_t              len;
+	}
+capture_t;
+
+#include "../examples/IRbench/captures.h"
+
+#define PANASONIC_CAPTURE  8
+#define FRAMES             (CAPTURES + 1)  // And the flipped Panasonic one
+#define REPS               20000           // Decodes of each, timed
+
+typedef
+	struct {
+		irraw_t         raw[RAWBUF];  // Gap first, in ticks
+		int             len;
+		decode_results  results;
+	}
+frame_t;
+
+IRrecv          irrecv(11);
+IRrecv          spanrecv(11);  // Its own protocol to try first
+decode_results  results;
+
+static frame_t  frames[FRAMES];
+
+//+=============================================================================
+// A capture's durations in ticks, after a 50mS gap
+//
+static void  load (frame_t *f,  const capture_t *cap)
+{
+	f->len = 0;
+	f->raw[f->len++] = 50000 / USECPERTICK;
+	for (int i = 0;  (i < cap->len) && (f->len < RAWBUF);  i++)  f->raw[f->len++] = cap->timing[i] / USECPERTICK ;
+}
+
+//+=============================================================================
+// Does data hold the frame's address and value bits, and count them all?
+//
+static bool  holdsBits (const decode_results *r)
+{
+#if IR_RESULT_BITS
+	irbits_t  want;
+	int       bits = (r->value == REPEAT) ? 0 : r->bits;  // A REPEAT has none
+
+	want.clear();
+	if (bits > 32)  want.append(r->address, bits - 32) ;
+	want.append(r->value, (bits > 32) ? 32 : bits);
+	return (r->data.count == bits) && want.equals(&r->data) && (want.hash() == r->data.hash());
+#else
+	(void)r;
+	return true;
+#endif
+}
+
+//+=============================================================================
+static void  printBits (const char *what,  const decode_results *r)
+{
+	printf("  %-11s type %2d %2d bits :", what, r->decode_type, r->bits);
+#if IR_RESULT_BITS
+	for (int i = 0;  (i < r->data.count) && (i < IR_RESULT_BITS);  i++)  printf("%s%d", (i & 7) ? "" : " ", r->data.get(i)) ;
+	if (r->data.count > IR_RESULT_BITS)  printf(" [and %d more]", r->data.count - IR_RESULT_BITS) ;
+#endif
+	printf("\n");
+}
+
+//+=============================================================================
+// nS on this PC's clock [micros() is the simulation's]
+//
+static unsigned long  wallNanos ( )
+{
+	struct timespec  now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000UL + now.tv_nsec;
+}
+
+//+=============================================================================
+int  main ( )
+{
+	unsigned long  start,  sink = 0;
+	char           name[16];
+	int            pairs = 0;
+	bool           ok    = true;
+
+	printf("IR_RESULT_BITS %d :\n", IR_RESULT_BITS);
+	for (unsigned int c = 0;  c < FRAMES;  c++) {
+		const capture_t  *cap  = &captures[(c < CAPTURES) ? c : PANASONIC_CAPTURE];
+		decode_results   *r    = &frames[c].results;
+		bool              same;
+
+		load(&frames[c], cap);
+		if (c == CAPTURES)  frames[c].raw[4] = 1250 / USECPERTICK ;  // The first address bit, 0 to 1
+
+		spanrecv.decodeSpan(r, frames[c].raw, frames[c].len);
+		same = (r->decode_type == cap->type);
+		if ((cap->type != UNKNOWN) && (c < CAPTURES))  same = same && ((uint32_t)r->value == (uint32_t)cap->value) ;
+
+		if (c < CAPTURES)  snprintf(name, sizeof(name), "capture %u", c) ;
+		else               snprintf(name, sizeof(name), "flipped") ;
+		printBits(name, r);
+		if (!same)          printf("    NOT AS CAPTURED\n") ;
+		if (!holdsBits(r))  printf("    DATA IS NOT ITS ADDRESS AND VALUE\n") ;
+		if (!same || !holdsBits(r))  ok = false ;
+	}
+
+#if IR_RESULT_BITS
+	// Equal data only for frames that decoded alike
+	for (unsigned int a = 0;  a < FRAMES;  a++) {
+		for (unsigned int b = 0;  b < FRAMES;  b++) {
+			const decode_results  *ra = &frames[a].results,  *rb = &frames[b].results;
+			bool                   alike, equal;
+
+			alike = (ra->decode_type == rb->decode_type) && (ra->bits == rb->bits) && (ra->value == rb->value)
+			        && ((ra->bits <= 32) || (ra->address == rb->address));
+			equal = (ra->decode_type == rb->decode_type) && ra->data.equals(&rb->data);
+			if ((alike != equal) || (equal && (ra->data.hash() != rb->data.hash()))) {
+				printf("  Frames %u and %u decoded %s, but their data %s\n", a, b, alike ? "alike" : "apart",
+				       equal ? "is equal" : "is not [or hashes apart]");
+				ok = false;
+			}
+			pairs++;
+		}
+	}
+	printf("  %d pairs of frames compared by data\n", pairs);
+#endif
+
+	// Streamed by the ISR : Decoded before the gap has ended
+	simStart();
+	irrecv.enableIRIn();
+	simRun(50000);
+	for (unsigned int c = 0;  c < CAPTURES;  c++) {
+		const capture_t  *cap = &captures[c];
+		unsigned long     end;
+
+		if ((cap->type != NEC) && (cap->type != SAMSUNG) && (cap->type != LG) && (cap->type != PANASONIC))  continue ;
+
+		irrecv.lockProtocol((decode_type_t)cap->type);
+		end = simRemote(micros() + 1000, cap->timing, cap->len);
+		simRun(end + _GAP / 2 - micros());
+		if (!irrecv.decode(&results)) {
+			printf("  capture %u was not streamed\n", c);
+			ok = false;
+		} else {
+			snprintf(name, sizeof(name), "streamed %u", c);
+			printBits(name, &results);
+			if (!holdsBits(&results) || ((uint32_t)results.value != (uint32_t)cap->value))  ok = false ;
+			irrecv.resume();
+		}
+		simRun(50000);
+	}
+	irrecv.lockProtocol(UNKNOWN);
+
+	start = wallNanos();
+	for (int n = 0;  n < REPS;  n++) {
+		for (unsigned int c = 0;  c < FRAMES;  c++) {
+			spanrecv.decodeSpan(&results, frames[c].raw, frames[c].len);
+			sink += results.value;
+		}
+	}
+	fprintf(stderr, "IR_RESULT_BITS %d : %lu nS per frame decoded [%lu]\n", IR_RESULT_BITS,
+	        (wallNanos() - start) / ((unsigned long)REPS * FRAMES), sink & 1);
+
+	printf("  %s\n", ok ? "Every frame's bits held, and told apart" : "FAILED");
+	return ok ? 0 : 1;
+}
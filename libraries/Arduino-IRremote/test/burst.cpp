@@ -0,0 +1,121 @@
+//******************************************************************************
+// Burst test : How many frames of a burst the receiver loses, when the sketch
+// only gets round to decode() every so often
+//
+// Plays NEC bursts in to the timer ISR, one 50uS tick at a time, and drains
+// every frame it has completed each time the sketch would look.  A frame that
+// ends while every capture slot is still held is lost.  Build it for each
+// IR_CAPTURE_SLOTS to compare them [make burst, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+extern "C" void  TIMER_INTR_NAME (void) ;
+
+IRrecv          irrecv(11);
+decode_results  results;
+
+//------------------------------------------------------------------------------
+// The burst, in uS : MARK, SPACE, MARK, SPACE ...
+//
+unsigned long  wave[1024];
+int            waveLen;
+
+static void  pulse (unsigned long mark,  unsigned long space)
+{
+	wave[waveLen++] = mark;
+	wave[waveLen++] = space;
+}
+
+// A frame, and the gap after it [NEC frames start 108mS apart]
+static void  nec (unsigned long data)
+{
+	pulse(9000, 4500);
+	for (unsigned long mask = 1UL << 31;  mask;  mask >>= 1)  pulse(560, (data & mask) ? 1690 : 560) ;
+	pulse(560, 40500);
+}
+
+static void  necRepeat ( )
+{
+	pulse(9000, 2250);
+	pulse(560, 96200);
+}
+
+//+=============================================================================
+// Play the burst, with decode() called every 'poll' mS [0 : After every tick]
+// Returns the number of frames decoded
+//
+static int  play (unsigned long poll)
+{
+	unsigned long  t     = 0;
+	int            count = 0;
+
+	irrecv.enableIRIn();
+
+	for (int i = -1;  i <= waveLen;  i++) {
+		// 20mS of quiet before it and after it
+		unsigned long  usec = ((i < 0) || (i == waveLen)) ? 20000 : wave[i];
+		bool           mark = (i >= 0) && (i < waveLen) && !(i & 1);
+
+		for ( ;  usec >= USECPERTICK;  usec -= USECPERTICK) {
+			PINB = mark ? 0 : _BV(digitalPinToPCMSKbit(11));  // The detector pulls the pin low for a MARK
+			setMicros(t);
+			TIMER_INTR_NAME();
+			t += USECPERTICK;
+
+			// The sketch looks [and once more, after it all]
+			if (poll && (t % (poll * 1000)) && (i < waveLen))  continue ;
+			while (irrecv.decode(&results)) {
+				if (results.decode_type == NEC)  count++ ;
+				irrecv.resume();
+			}
+		}
+	}
+
+	return count;
+}
+
+//+=============================================================================
+// One line of the table
+//
+static const unsigned long  polls[] = {0, 50, 100, 250};
+#define POLLS  (sizeof(polls) / sizeof(polls[0]))
+
+static void  report (const char *name,  int frames)
+{
+	printf("%-22s %6d", name, frames);
+	for (unsigned int p = 0;  p < POLLS;  p++)  printf(" %7d", play(polls[p])) ;
+	printf("\n");
+}
+
+//+=============================================================================
+int  main ( )
+{
+	printf("IR_CAPTURE_SLOTS %d : NEC frames decoded, with decode() called every\n", IR_CAPTURE_SLOTS);
+	printf("%-22s %6s", "", "sent");
+	for (unsigned int p = 0;  p < POLLS;  p++)  printf(" %4lu mS", polls[p]) ;
+	printf("\n");
+
+	// A button held down : Its code, then repeats
+	waveLen = 0;
+	nec(0x20DF10EF);
+	for (int i = 0;  i < 4;  i++)  necRepeat() ;
+	report("Held, 4 repeats", 5);
+
+	// A button mashed : The whole code, each time
+	waveLen = 0;
+	for (int i = 0;  i < 6;  i++)  nec(0x20DF10EF) ;
+	report("Pressed 6 times", 6);
+
+	// Two buttons at once : Frames back to back
+	waveLen = 0;
+	for (int i = 0;  i < 3;  i++) {
+		nec(0x20DF10EF);
+		wave[waveLen - 1] = 6000;
+		nec(0x20DF906F);
+		wave[waveLen - 1] = 6000;
+	}
+	report("Two, back to back", 6);
+
+	return 0;
+}
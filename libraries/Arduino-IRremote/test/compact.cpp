@@ -0,0 +1,100 @@
+//******************************************************************************
+// Compact test : With one byte per duration [IR_COMPACT_RAWBUF], the receiver
+// captures and decodes what it does with two
+//
+// On the virtual Timer2 of sim.h, the remote sends each of the IRbench
+// captures, 50mS apart, then two frames with MARKs too long for a byte :
+//   long  : A 15mS header and a 13mS MARK, as some A/C remotes send them.
+//           They and the gap fit the table of long durations.
+//   clip  : 10 MARKs of 13mS, more than the table holds [IR_RAW_LONGS].  The
+//           full rawbuf keeps them all; The compact one keeps as many as
+//           the table has room for after the gap, and reads the rest as
+//           IR_RAW_ESCAPE - 1, the longest a byte holds.
+// Prints each frame as decoded, with every duration as rawAt() reads it, so
+// the two builds can be compared line by line; They must be the same but for
+// the durations the compact rawbuf clips, which are checked here.  Prints the
+// size of irparams to stderr [make compact, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+#include "sim.h"
+
+typedef
+	struct {
+		int8_t               type;    // What it should decode as
+		unsigned long        value;
+		const unsigned int  *timing;  // uS, as IRrecvDumpV2 prints them
+		uint8_t              len;
+	}
+capture_t;
+
+#include "../examples/IRbench/captures.h"
+
+#define LONG_MARK  13000  // uS, 260 ticks
+#define CLIP_MARKS 10
+
+static const unsigned int  longFrame[] = {15000, 4000, 600, 1600, 600, 600, LONG_MARK, 1600, 600, 600, 600};
+static unsigned int        clipFrame[2 * CLIP_MARKS - 1];
+
+IRrecv          irrecv(11);
+decode_results  results;
+
+//+=============================================================================
+// Send a frame, and print what was decoded of it; Returns how many frames
+//
+static int  play (const char *name,  const unsigned int *usec,  int len)
+{
+	unsigned long  t     = simRemote(micros() + 1000, usec, len) + 50000;
+	int            count = 0;
+
+	while (micros() < t) {
+		simRun(1000);
+		if (!irrecv.decode(&results))  continue ;
+
+		printf("%-16s type %2d value %8lX bits %2d rawlen %3d overflow %d :", name, results.decode_type,
+		       (unsigned long)(uint32_t)results.value, results.bits, results.rawlen, results.overflow);
+		for (int i = 1;  i < results.rawlen;  i++)  printf(" %u", results.rawAt(i)) ;
+		printf("\n");
+		count++;
+		irrecv.resume();
+	}
+	return count;
+}
+
+//+=============================================================================
+int  main ( )
+{
+	char  name[16];
+	int   clipped = 0;
+	bool  ok      = true;
+
+	simStart();
+	irrecv.enableIRIn();
+	simRun(50000);
+
+	for (unsigned int c = 0;  c < CAPTURES;  c++) {
+		snprintf(name, sizeof(name), "capture %u", c);
+		if (play(name, captures[c].timing, captures[c].len) != 1)  ok = false ;
+	}
+	if (play("long", longFrame, sizeof(longFrame) / sizeof(longFrame[0])) != 1)  ok = false ;
+
+	// The MARKs past the table : Clipped in a byte, whole in two
+	for (int i = 0;  i < 2 * CLIP_MARKS - 1;  i++)  clipFrame[i] = (i & 1) ? 600 : LONG_MARK ;
+	ok = (play("clip", clipFrame, 2 * CLIP_MARKS - 1) == 1) && ok;
+	for (int i = 1;  i < results.rawlen;  i += 2) {
+		if (results.rawAt(i) < LONG_MARK / USECPERTICK)  clipped++ ;
+#if IR_COMPACT_RAWBUF
+		if ((results.rawAt(i) < LONG_MARK / USECPERTICK) && (results.rawAt(i) != IR_RAW_ESCAPE - 1))  ok = false ;
+#endif
+	}
+	fprintf(stderr, "IR_COMPACT_RAWBUF %d : irparams takes %u bytes, %d long MARKs of %d clipped\n",
+	        IR_COMPACT_RAWBUF, (unsigned int)sizeof(irparams), clipped, CLIP_MARKS);
+#if IR_COMPACT_RAWBUF
+	if (clipped != CLIP_MARKS - (IR_RAW_LONGS - 1))  ok = false ;  // The gap takes an entry
+#else
+	if (clipped)  ok = false ;
+#endif
+
+	printf("%s\n", ok ? "Every frame decoded once" : "FAILED");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+//******************************************************************************
+// Edge test : The edge ISR [IR_RECV_EDGE] decodes what the timer ISR does, at a
+// fraction of the interrupts
+//
+// Plays the IRbench captures in to the receiver on pin 11 : Built with
+// IR_RECV_EDGE, one pin-change interrupt per edge with micros() at its time;
+// Without, the timer ISR every 50uS [at the full rate, IR_ADAPTIVE_RATE 0].
+// Prints what each capture decoded as, and the interrupts it all took, so
+// the two builds can be compared [make edge, see the Makefile].  A capture
+// that should only hash is right if it hashes as it does when decoded as it
+// is [as IRbench checks them].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+#if IR_RECV_EDGE && !defined(IR_RECV_PCINT)
+#	error "Build it with -DIR_RECV_PIN=11"
+#endif
+
+typedef
+	struct {
+		int8_t               type;    // What it should decode as
+		unsigned long        value;
+		const unsigned int  *timing;  // uS, as IRrecvDumpV2 prints them
+		uint8_t              len;
+	}
+capture_t;
+
+#include "../examples/IRbench/captures.h"
+
+#if IR_RECV_EDGE
+extern "C" void  IR_RECV_PCINT (void) ;
+#else
+extern "C" void  TIMER_INTR_NAME (void) ;
+#endif
+
+IRrecv          irrecv(11);
+decode_results  results;
+
+unsigned long  now;       // uS
+unsigned long  tick;      // uS of the next timer interrupt
+unsigned long  isrCalls;  // Interrupts taken
+
+//+=============================================================================
+// What the capture decodes as, as it is : Its durations, after a 50mS gap
+//
+static void  expect (const capture_t *cap,  decode_results *results)
+{
+	irraw_t  buf[RAWBUF];
+	int      len = 0;
+
+	buf[len++] = 50000 / USECPERTICK;
+	for (int i = 0;  (i < cap->len) && (len < RAWBUF);  i++)  buf[len++] = cap->timing[i] / USECPERTICK ;
+	irrecv.decodeSpan(results, buf, len);
+}
+
+//+=============================================================================
+// The pin is at this level for usec
+//
+static void  level (bool mark,  unsigned long usec)
+{
+	PINB = mark ? 0 : _BV(digitalPinToPCMSKbit(11));  // The detector pulls the pin low for a MARK
+
+#if IR_RECV_EDGE
+	setMicros(now);
+	IR_RECV_PCINT();
+	isrCalls++;
+#else
+	for ( ;  tick < now + usec;  tick += USECPERTICK) {
+		setMicros(tick);
+		TIMER_INTR_NAME();
+		isrCalls++;
+	}
+#endif
+	now += usec;
+}
+
+//+=============================================================================
+int  main ( )
+{
+	int  same = 0;
+
+	// 50mS of quiet before each capture [Sony takes shorter gaps for repeats]
+	irrecv.enableIRIn();
+	level(false, 50000);
+
+	for (unsigned int c = 0;  c < CAPTURES;  c++) {
+		const capture_t  *cap   = &captures[c];
+		unsigned long     value = cap->value;
+
+		// UNKNOWN : Its hash
+		if (cap->type == UNKNOWN) {
+			expect(cap, &results);
+			value = results.value;
+		}
+
+		for (int i = 0;  i < cap->len;  i++)  level(!(i & 1), cap->timing[i]) ;
+		level(false, 50000);
+
+		setMicros(now);
+		if (irrecv.decode(&results)) {
+			printf("%2u : type %2d value %8lX -> type %2d value %8lX\n", c, cap->type, (unsigned long)(uint32_t)value,
+			       results.decode_type, (unsigned long)(uint32_t)results.value);
+			if ((results.decode_type == cap->type) && ((uint32_t)results.value == (uint32_t)value))  same++ ;
+			irrecv.resume();
+		} else {
+			printf("%2u : type %2d value %8lX -> nothing\n", c, cap->type, (unsigned long)(uint32_t)value);
+		}
+	}
+
+	printf("IR_RECV_EDGE %d : %d of %u as captured, %lu interrupts over %lu mS\n",
+	       IR_RECV_EDGE, same, (unsigned int)CAPTURES, isrCalls, now / 1000);
+	return (same == (int)CAPTURES) ? 0 : 1;
+}
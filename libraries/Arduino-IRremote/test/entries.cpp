@@ -0,0 +1,165 @@
+//******************************************************************************
+// Entries test : decode() only runs the decoders whose header signature fits,
+// and the one that decoded last first
+//
+// Built with -finstrument-functions, every function entered is looked up by
+// name, and the protocol decoders [IRrecv::decodeNEC() and the like] counted.
+// Each IRbench capture is decoded after the one before it [after another
+// protocol, mostly] and then again [the same one again].  Again, only its own
+// decoder may run; After another, no more than the signatures let through.
+// Every capture must decode as captured, and again after each other capture
+// [the protocol tried first must not take another's frame, as LG once took
+// NEC's].  Prints the decoders run for each, and how many a plain walk down
+// signatures[] would have run to get to it [make entries, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+
+typedef
+	struct {
+		int8_t               type;    // What it should decode as
+		unsigned long        value;
+		const unsigned int  *timing;  // uS, as IRrecvDumpV2 prints them
+		uint8_t              len;
+	}
+capture_t;
+
+#include "../examples/IRbench/captures.h"
+
+#define MAX_AFTER  3  // Decoders a frame may run after another protocol
+
+// The protocol decoders, in the order decode() used to try them all
+static const struct {
+	decode_type_t  type;
+	const char    *name;  // IRrecv::decode<name>()
+} decoders[] = {
+	{NEC,          "NEC"},
+	{SONY,         "Sony"},
+	{SANYO,        "Sanyo"},
+	{MITSUBISHI,   "Mitsubishi"},
+	{RC5,          "RC5"},
+	{RC6,          "RC6"},
+	{PANASONIC,    "Panasonic"},
+	{LG,           "LG"},
+	{JVC,          "JVC"},
+	{SAMSUNG,      "SAMSUNG"},
+	{WHYNTER,      "Whynter"},
+	{AIWA_RC_T501, "AiwaRCT501"},
+	{DENON,        "Denon"},
+};
+#define DECODERS  (sizeof(decoders) / sizeof(decoders[0]))
+
+IRrecv          irrecv(11);
+decode_results  results;
+
+unsigned long   entered;  // Protocol decoders run
+
+//+=============================================================================
+// Which decoder, if any, a function is [by its name]; -1 if none
+//
+__attribute__((no_instrument_function))
+static int  decoderOf (void *fn)
+{
+	Dl_info  info;
+	char    *name;
+	int      status, found = -1;
+
+	if (!dladdr(fn, &info) || !info.dli_sname)  return -1 ;
+	if (!(name = abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status)))  return -1 ;
+
+	for (unsigned int d = 0;  d < DECODERS;  d++) {
+		size_t  len = strlen(decoders[d].name);
+
+		if (!strncmp(name, "IRrecv::decode", 14) && !strncmp(name + 14, decoders[d].name, len) && (name[14 + len] == '('))
+			found = d;
+	}
+	free(name);
+	return found;
+}
+
+//+=============================================================================
+// Each function entered : Count it if it is a decoder [the answer is cached]
+//
+extern "C" __attribute__((no_instrument_function))
+void  __cyg_profile_func_enter (void *fn,  void *site __attribute__((unused)))
+{
+	static void  *seen[1024];
+	static bool   isDecoder[1024];
+	static int    count;
+
+	for (int i = 0;  i < count;  i++) {
+		if (seen[i] == fn)  { entered += isDecoder[i];  return; }
+	}
+	if (count < 1024) {
+		seen[count]      = fn;
+		isDecoder[count] = (decoderOf(fn) >= 0);
+		entered += isDecoder[count++];
+	}
+}
+
+extern "C" __attribute__((no_instrument_function))
+void  __cyg_profile_func_exit (void *fn __attribute__((unused)),  void *site __attribute__((unused)))
+{
+}
+
+//+=============================================================================
+// Decode the capture as it is, after a 50mS gap; Returns the decoders run
+//
+static unsigned long  decodeCapture (const capture_t *cap)
+{
+	static irraw_t  buf[RAWBUF];
+	int             len   = 0;
+	unsigned long   start = entered;
+
+	buf[len++] = 50000 / USECPERTICK;
+	for (int i = 0;  (i < cap->len) && (len < RAWBUF);  i++)  buf[len++] = cap->timing[i] / USECPERTICK ;
+	irrecv.decodeSpan(&results, buf, len);
+	return entered - start;
+}
+
+//+=============================================================================
+int  main ( )
+{
+	bool  ok = true;
+
+	printf("Decoders run         after another  again  [all in order]\n");
+	for (unsigned int c = 0;  c < CAPTURES;  c++) {
+		const capture_t  *cap    = &captures[c];
+		unsigned long     after  = decodeCapture(cap);
+		unsigned long     again  = decodeCapture(cap);
+		bool              same   = (results.decode_type == cap->type);
+		int               walked = 0;
+
+		// A hash only has to be one [it runs no decoder of its own]
+		if (cap->type != UNKNOWN)  same = same && ((uint32_t)results.value == (uint32_t)cap->value) ;
+		while ((walked < (int)DECODERS) && (decoders[walked++].type != cap->type)) ;
+
+		printf("  %2u %-12s %9lu %11lu   %4d%s\n", c, (cap->type == UNKNOWN) ? "[hash]" : decoders[walked - 1].name,
+		       after, again, walked, same ? "" : "  NOT AS CAPTURED");
+		if (!same || (after > MAX_AFTER) || ((cap->type != UNKNOWN) && (again != 1)))  ok = false ;
+	}
+
+	// After every other capture, with its protocol tried first
+	for (unsigned int c = 0;  c < CAPTURES;  c++) {
+		for (unsigned int k = 0;  k < CAPTURES;  k++) {
+			const capture_t  *cap = &captures[c];
+			bool              same;
+
+			decodeCapture(&captures[k]);
+			decodeCapture(cap);
+			same = (results.decode_type == cap->type);
+			if (cap->type != UNKNOWN)  same = same && ((uint32_t)results.value == (uint32_t)cap->value) ;
+			if (same)  continue ;
+
+			printf("  %2u after %2u : decoded as type %d, NOT AS CAPTURED\n", c, k, results.decode_type);
+			ok = false;
+		}
+	}
+
+	printf("%s\n", ok ? "Every capture decoded, running its own decoder alone the second time"
+	                  : "FAILED : A capture decoded wrong, or ran other decoders");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+//******************************************************************************
+// Fingerprint test : A button hashes the same from press to press more often
+// than with the old hash, and no two buttons hash or fingerprint alike
+//
+// 45 buttons are sent by the library on the virtual Timer2 of sim.h, and
+// captured by its own receiver, the detector seeing the LED : 5 each of NEC,
+// Samsung, Sony, RC5, RC6, Panasonic, JVC, LG, and a made-up protocol whose
+// SPACEs are only 1.3x apart.  Then PRESSES presses of them, each duration off by up to the jitter
+// either way, are hashed by fingerprint() and by the old decodeHash() [each
+// duration shorter, equal or longer than the one two before, 20% margins].
+// The buttons must all hash apart, no press may be within
+// fingerprintDistance() 0 of another button, and from 10% jitter up the new
+// hash must be the steadier.  Prints how often a press hashed as its button
+// did, and the time per frame on this PC [make fingerprint, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+#include "sim.h"
+
+#include <time.h>
+
+#if IR_ECHO_MUTE
+#	error "Build it with -DIR_ECHO_MUTE=0 : The receiver captures the LED"
+#endif
+
+#define VALUES   5
+#define KINDS    9
+#define BUTTONS  (VALUES * KINDS)
+#define PRESSES  4000  // Per jitter
+
+typedef
+	struct {
+		irraw_t  raw[RAWBUF];  // Gap first, in ticks
+		int      len;
+	}
+button_t;
+
+IRrecv          irrecv(11);
+IRsend          irsend;
+decode_results  results;
+
+static button_t  buttons[BUTTONS];
+
+static const unsigned long  values[VALUES] = {0x20DF10EF, 0x20DF906F, 0x10EF50AF, 0xA55A0FF0, 0x00FF30CF};
+
+//+=============================================================================
+// The old decodeHash() : Each duration against the one two before it
+//
+#define FNV_PRIME_32 16777619
+#define FNV_BASIS_32 2166136261
+
+static int  oldCompare (unsigned int oldval,  unsigned int newval)
+{
+	if      (newval < oldval * .8)  return 0 ;
+	else if (oldval < newval * .8)  return 2 ;
+	else                            return 1 ;
+}
+
+static long  oldHash (decode_results *results)
+{
+	long  hash = FNV_BASIS_32;
+
+	for (int i = 1;  (i + 2) < results->rawlen;  i++)  hash = (hash * FNV_PRIME_32) ^ oldCompare(results->rawAt(i), results->rawAt(i + 2)) ;
+	return hash;
+}
+
+//+=============================================================================
+// A frame of the made-up protocol : 24 bits, MARK and SPACE both carry them
+//
+static void  sendMadeUp (unsigned long value)
+{
+	unsigned int  usec[2 + 48 + 1];
+	int           len = 0;
+
+	usec[len++] = 3300;
+	usec[len++] = 1300;
+	for (int i = 23;  i >= 0;  i--) {
+		bool  one = (value >> i) & 1;
+
+		usec[len++] = one ? 800 : 350;
+		usec[len++] = one ? 450 : 1000;
+	}
+	usec[len++] = 350;
+	irsend.sendRaw(usec, len, 38);
+}
+
+//+=============================================================================
+// Send button b, and keep what the receiver captured of it
+//
+static bool  record (int b)
+{
+	unsigned long  v = values[b / KINDS];
+
+	switch (b % KINDS) {
+		case 0 :  irsend.sendNEC(v, 32);                       break;
+		case 1 :  irsend.sendSAMSUNG(v ^ 0xE0E00000, 32);      break;
+		case 2 :  irsend.sendSony(v & 0xFFF, 12);              break;
+		case 3 :  irsend.sendRC5(v & 0xFFF, 12);               break;
+		case 4 :  irsend.sendRC6(v & 0xFFFFF, 20);             break;
+		case 5 :  irsend.sendPanasonic(0x4004, v);             break;
+		case 6 :  irsend.sendJVC(v & 0xFFFF, 16, false);       break;
+		case 7 :  irsend.sendLG(v & 0xFFFFFFF, 28);            break;
+		case 8 :  sendMadeUp(v ^ 0x5A5A5A);                    break;
+	}
+	simRun(50000);
+
+	if (!irrecv.decode(&results))  return false ;
+	for (int i = 0;  i < results.rawlen;  i++)  buttons[b].raw[i] = results.rawAt(i) ;
+	buttons[b].len = results.rawlen;
+	irrecv.resume();
+	return true;
+}
+
+//+=============================================================================
+// nS on this PC's clock [micros() is the simulation's]
+//
+static unsigned long  wallNanos ( )
+{
+	struct timespec  now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000UL + now.tv_nsec;
+}
+
+//+=============================================================================
+// A press of button b, each duration off by up to jitter percent
+//
+static void  press (int b,  int jitter,  irraw_t *raw)
+{
+	for (int i = 0;  i < buttons[b].len;  i++) {
+		long  ticks = buttons[b].raw[i];
+
+		if (i)  ticks += (ticks * random(-jitter, jitter + 1) + 50) / 100 ;
+		raw[i] = (ticks < 1) ? 1 : ticks;
+	}
+	results.rawbuf = raw;
+	results.rawlen = buttons[b].len;
+	results.tick   = USECPERTICK;
+}
+
+//+=============================================================================
+int  main ( )
+{
+	static irfingerprint_t  ref[BUTTONS];
+	static long             refOld[BUTTONS];
+	static irraw_t          raw[RAWBUF];
+	int                     collisions = 0,  oldCollisions = 0;
+	bool                    ok = true;
+
+	simStart();
+	simEcho = true;
+	irrecv.enableIRIn();
+	simRun(50000);
+	for (int b = 0;  b < BUTTONS;  b++) {
+		if (!record(b)) {
+			printf("Button %d was not captured\n", b);
+			return 1;
+		}
+		press(b, 0, raw);
+		irrecv.fingerprint(&results, &ref[b]);
+		refOld[b] = oldHash(&results);
+	}
+
+	for (int b = 0;  b < BUTTONS;  b++) {
+		for (int k = 0;  k < b;  k++) {
+			collisions    += (ref[b].hash == ref[k].hash);
+			oldCollisions += (refOld[b] == refOld[k]);
+		}
+	}
+	printf("%d buttons : %d hash alike [old hash %d]\n", BUTTONS, collisions, oldCollisions);
+	if (collisions)  ok = false ;
+
+	randomSeed(1);
+	printf("  jitter   same hash : old     new     wrong button   nS/frame : old  new\n");
+	for (int jitter = 5;  jitter <= 20;  jitter += 5) {
+		unsigned long  same = 0,  sameOld = 0,  wrong = 0,  ns = 0,  nsOld = 0;
+
+		for (int n = 0;  n < PRESSES;  n++) {
+			int              b = n % BUTTONS;
+			irfingerprint_t  fp;
+			unsigned long    start;
+			long             hash;
+
+			press(b, jitter, raw);
+
+			start = wallNanos();
+			hash  = oldHash(&results);
+			nsOld += wallNanos() - start;
+
+			start = wallNanos();
+			irrecv.fingerprint(&results, &fp);
+			ns += wallNanos() - start;
+
+			sameOld += (hash == refOld[b]);
+			same    += (fp.hash == ref[b].hash);
+			for (int k = 0;  k < BUTTONS;  k++) {
+				if ((k != b) && !IRrecv::fingerprintDistance(&ref[k], &fp, 0))  { wrong++;  break; }
+			}
+		}
+
+		printf("  +-%2d%%              %5.1f%%  %5.1f%%  %5.1f%%                 %5lu %5lu\n", jitter,
+		       100.0 * sameOld / PRESSES, 100.0 * same / PRESSES, 100.0 * wrong / PRESSES, nsOld / PRESSES, ns / PRESSES);
+		if (wrong || ((jitter >= 10) && (same <= sameOld)))  ok = false ;
+	}
+
+	printf("%s\n", ok ? "No two buttons alike, and the new hash is the steadier"
+	                  : "FAILED : Buttons alike, or the new hash is no steadier");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+//******************************************************************************
+// Glitch test : With IR_GLITCH_TICKS, spikes of ambient IR in SPACEs and
+// dropouts in MARKs no longer break the frames they land in
+//
+// Each IRbench capture is put in a capture slot as the ISR would, as it is and
+// then PASSES times with JITTER_PCT jitter, each jittered copy both without
+// spikes and with SPIKE_PCT of them : A duration broken in three by a one-tick
+// MARK [in a SPACE] or SPACE [in a MARK], as IRbench makes them.  Every
+// capture as it is must decode as captured.  capture() must hand over the
+// copies without spikes as they are, and the same durations again when run a
+// second time on any frame [the filter changes nothing the second time].
+//   Built with IR_GLITCH_TICKS, capture() must hand over each spiked copy
+//   just as the copy without spikes, so they decode alike [unless the spikes
+//   overflowed RAWBUF, as they do Panasonic's 100 durations].
+//   Built without it, the spikes must break frames [or the test tells
+//   nothing].
+// Prints how often each capture decoded as captured, without spikes and with
+// [make glitch, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+typedef
+	struct {
+		int8_t               type;    // What it should decode as
+		unsigned long        value;
+		const unsigned int  *timing;  // uS, as IRrecvDumpV2 prints them
+		uint8_t              len;
+	}
+capture_t;
+
+#include "../examples/IRbench/captures.h"
+
+#define PASSES      200  // Jittered copies of each capture
+#define JITTER_PCT  10
+#define SPIKE_PCT   3
+
+IRrecv          irrecv(11);
+decode_results  results;
+
+//+=============================================================================
+// Store one duration in a slot, the way the ISR does [see IRbench.ino]
+//
+static void  store (volatile irslot_t *slot,  unsigned int t)
+{
+#if IR_COMPACT_RAWBUF
+	if (t >= IR_RAW_ESCAPE) {
+		if (slot->rawlongs < IR_RAW_LONGS) {
+			slot->rawlong[slot->rawlongs] = t;
+			t = IR_RAW_ESCAPE + slot->rawlongs++;
+		} else {
+			t = IR_RAW_ESCAPE - 1;
+		}
+	}
+#endif
+	if (slot->rawlen < RAWBUF)  slot->rawbuf[slot->rawlen++] = t ;
+	else                        slot->overflow = true ;
+}
+
+//+=============================================================================
+// Hand durations [ticks, gap first] to the receiver as the ISR would
+//
+static void  replay (const unsigned int *ticks,  int len)
+{
+	volatile irslot_t  *slot = &irparams.slot[IR_SLOT(irparams.head)];
+
+	slot->rawlen   = 0;
+	slot->overflow = false;
+	slot->stamp    = millis();
+#if IR_COMPACT_RAWBUF
+	slot->rawlongs = 0;
+#endif
+#if IR_RECV_STREAM
+	slot->streamed = false;
+#endif
+	for (int i = 0;  i < len;  i++)  store(slot, ticks[i]) ;
+	irparams.head++;
+}
+
+//+=============================================================================
+// The capture in ticks, after a 50mS gap, each duration off by up to the
+// jitter either way; Returns how many
+//
+static int  jitter (const capture_t *cap,  int pct,  unsigned int *ticks)
+{
+	int  len = 0;
+
+	ticks[len++] = 1000;
+	for (int i = 0;  i < cap->len;  i++) {
+		unsigned int  t = cap->timing[i] / USECPERTICK;
+
+		t += (long)t * random(-pct, pct + 1) / 100;
+		ticks[len++] = (t < 1) ? 1 : t;
+	}
+	return len;
+}
+
+//+=============================================================================
+// The same durations with spikes in them; Returns how many
+//
+static int  spike (const unsigned int *ticks,  int len,  unsigned int *spiked)
+{
+	int  n = 0;
+
+	spiked[n++] = ticks[0];
+	for (int i = 1;  i < len;  i++) {
+		unsigned int  t = ticks[i];
+
+		// A spike : SPACE, short MARK, SPACE [or a dropout : MARK, short SPACE, MARK]
+		if ((t > 4) && (random(100) < SPIKE_PCT)) {
+			spiked[n++] = t / 2;
+			spiked[n++] = 1;
+			t -= t / 2 + 1;
+		}
+		spiked[n++] = t;
+	}
+	return n;
+}
+
+//+=============================================================================
+// Does capture() hand over these durations, and the same again the second
+// time? [ticks NULL : Only the same again]
+//
+static bool  handsOver (const unsigned int *ticks,  int len)
+{
+	static unsigned int  first[RAWBUF];
+	bool                 same;
+
+	irrecv.capture(&results);
+	same = !ticks || (results.rawlen == len);
+	len  = results.rawlen;
+	for (int i = 0;  i < len;  i++) {
+		first[i] = results.rawAt(i);
+		if (ticks && (first[i] != ticks[i]))  same = false ;
+	}
+
+	irrecv.capture(&results);
+	if (results.rawlen != len)  return false ;
+	for (int i = 0;  i < len;  i++)  if (results.rawAt(i) != first[i])  return false ;
+	return same;
+}
+
+//+=============================================================================
+// Decode the frame in the slot; Is it what was captured?
+//
+static bool  decodes (const capture_t *cap)
+{
+	bool  same;
+
+	if (!irrecv.decode(&results))  return false ;  // Too short even to hash; decode() has resumed
+
+	same = (results.decode_type == cap->type);
+	if (cap->type != UNKNOWN)  same = same && ((uint32_t)results.value == (uint32_t)cap->value) ;
+	irrecv.resume();
+	return same;
+}
+
+//+=============================================================================
+int  main ( )
+{
+	static unsigned int  ticks[RAWBUF],  spiked[3 * RAWBUF];
+	int                  broken = 0;
+	bool                 ok     = true;
+
+	randomSeed(1);
+
+	printf("IR_GLITCH_TICKS %d, jitter %d%%, spikes %d%% :\n", IR_GLITCH_TICKS, JITTER_PCT, SPIKE_PCT);
+	printf("  capture      as it is      as captured : jittered  and spiked\n");
+	for (unsigned int c = 0;  c < CAPTURES;  c++) {
+		const capture_t  *cap    = &captures[c];
+		int               len    = jitter(cap, 0, ticks);
+		bool              clean;
+		int               right  = 0,  rightSpiked = 0,  overflows = 0,  differ = 0;
+
+		replay(ticks, len);
+		if (!handsOver(ticks, len))  differ++ ;
+		clean = decodes(cap);
+
+		for (int pass = 0;  pass < PASSES;  pass++) {
+			int   n = spike(ticks, len = jitter(cap, JITTER_PCT, ticks), spiked);
+			bool  overflow = (n > RAWBUF),  jitteredRight,  spikedRight;
+
+			replay(ticks, len);
+			if (!handsOver(ticks, len))  differ++ ;
+			right += (jitteredRight = decodes(cap));
+
+			// Filtered, it must be the copy without spikes again
+			replay(spiked, n);
+			overflows += overflow;
+			if (!handsOver((IR_GLITCH_TICKS && !overflow) ? ticks : NULL, len))  differ++ ;
+			rightSpiked += (spikedRight = decodes(cap));
+#if IR_GLITCH_TICKS
+			if (!overflow && (spikedRight != jitteredRight))  differ++ ;
+#endif
+		}
+
+		printf("  %2u type %2d   %-15s   %5.1f%%    %5.1f%%", c, cap->type, clean ? "as captured" : "NOT AS CAPTURED",
+		       100.0 * right / PASSES, 100.0 * rightSpiked / PASSES);
+		if (overflows)  printf("  [%d overflowed]", overflows) ;
+		if (differ)     printf("  %d CHANGED, OR NOT AS WITHOUT SPIKES", differ) ;
+		printf("\n");
+
+		if (!clean || differ)  ok = false ;
+		if (rightSpiked < right)  broken++ ;
+	}
+
+#if IR_GLITCH_TICKS
+	printf("  %s\n", ok ? "Every frame that fit came out of capture() as it was without spikes" : "FAILED");
+#else
+	if (!broken)  ok = false ;
+	printf("  %s\n", ok ? "The spikes broke frames" : "FAILED");
+#endif
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+//******************************************************************************
+// Loopback test : A sketch that answers a remote keeps receiving while and
+// after it sends, and does not hear itself [IR_FULL_DUPLEX, IR_ECHO_MUTE]
+//
+// On the virtual Timer2 of sim.h, a remote sends NEC frame A, then D while the
+// sketch is answering and C after it has.  The sketch decodes A and answers
+// with B, blocking [sendNEC()] or queued [sendRawAsync()].
+//   mute     : Built with IR_ECHO_MUTE, the detector seeing the LED.  A and
+//              C are decoded, C as soon after it ends as A is; B, our own
+//              echo, is not.  D, which overlaps B, is lost to the mute.
+//   shielded : Built with IR_ECHO_MUTE 0, the detector not seeing the LED.
+//              D is decoded as well.
+// Prints each frame decoded and when [make loopback, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+#include "sim.h"
+
+#if !IR_SEND_ASYNC
+#	error "Build it with -DIR_SEND_ASYNC=1"
+#endif
+
+#define A  0x20DF10EF  // From the remote
+#define B  0x10EFA05F  // Our answer
+#define C  0x20DF8877  // From the remote, after B
+#define D  0x20DF40BF  // From the remote, during B
+
+IRrecv          irrecv(11);
+IRsend          irsend;
+decode_results  results;
+
+//+=============================================================================
+// An NEC frame in uS, MARK first
+//
+static int  nec (unsigned int *usec,  unsigned long value)
+{
+	int  len = 0;
+
+	usec[len++] = 9000;
+	usec[len++] = 4500;
+	for (int i = 31;  i >= 0;  i--) {
+		usec[len++] = 560;
+		usec[len++] = ((value >> i) & 1) ? 1690 : 560;
+	}
+	usec[len++] = 560;
+	return len;
+}
+
+//+=============================================================================
+static const char *  name (unsigned long value)
+{
+	switch (value) {
+		case A :  return "A";
+		case B :  return "B [our own]";
+		case C :  return "C";
+		case D :  return "D [during B]";
+	}
+	return "?";
+}
+
+//+=============================================================================
+int  main (int argc,  char *argv[])
+{
+	static const unsigned long  values[4] = {A, B, C, D};
+	static unsigned int  frame[4][68];
+	bool                 queued = (argc > 1) && !strcmp(argv[1], "queued");
+	unsigned long        end[4], seen[4] = {0}, t;
+	int                  len;
+	bool                 answered = false, ok = true;
+
+	simStart();
+	simEcho = IR_ECHO_MUTE;  // Without the mute, shield the detector from the LED
+
+	len    = nec(frame[0], A);
+	end[0] = simRemote(20000, frame[0], len);
+	nec(frame[3], D);
+	end[3] = simRemote(130000, frame[3], len);
+	nec(frame[2], C);
+	end[2] = simRemote(220000, frame[2], len);
+	nec(frame[1], B);
+
+	printf("IR_ECHO_MUTE %d, detector %s, %s answer :\n", IR_ECHO_MUTE, simEcho ? "sees the LED" : "shielded",
+	       queued ? "queued" : "blocking");
+
+	irrecv.enableIRIn();
+	while ((t = micros()) < 360000) {
+		simRun(100);
+		if (!irrecv.decode(&results))  continue ;
+
+		printf("  %6lu uS : %08lX %s\n", t, (unsigned long)(uint32_t)results.value, name(results.value));
+		for (int f = 0;  f < 4;  f++) {
+			if ((results.decode_type == NEC) && (results.value == values[f]))  seen[f] = t ;
+		}
+		irrecv.resume();
+
+		if (!answered && (results.value == A)) {
+			answered = true;
+			if (queued)  irsend.sendRawAsync(frame[1], len, 38) ;
+			else         irsend.sendNEC(B, 32) ;
+		}
+	}
+
+	// B went out; A and C came in, as quickly; B did not; D only without the mute
+	if (simLedEdges != len + 1) {
+		printf("  B was not sent : The LED changed %d times\n", simLedEdges);
+		ok = false;
+	}
+	if (!seen[0] || !seen[2]) {
+		printf("  A or C was lost\n");
+		ok = false;
+	} else {
+		long  a = seen[0] - end[0], c = seen[2] - end[2];
+
+		printf("  A decoded %.1f mS after it ended, C %.1f mS\n", a / 1000.0, c / 1000.0);
+		if (labs(c - a) > 1000)  ok = false ;
+	}
+	if (seen[1]) {
+		printf("  Our own B was heard\n");
+		ok = false;
+	}
+	if (!seen[3] == !IR_ECHO_MUTE) {
+		printf("  D was %s\n", seen[3] ? "decoded through the mute" : "lost");
+		ok = false;
+	}
+	printf("  %s\n", ok ? "As expected" : "FAILED");
+	return ok ? 0 : 1;
+}
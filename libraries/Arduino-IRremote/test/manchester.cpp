@@ -0,0 +1,298 @@
+//******************************************************************************
+// Manchester test : decodeManchester() decodes RC5 and RC6 as getRClevel() did,
+// and returns the bits past 32 of an RC6 mode 6A / MCE frame in address
+//
+// RC5 [12 bits] and RC6 [20 bits] frames are sent by the library on the
+// virtual Timer2 of sim.h, and 36 bit MCE frames with sendRaw() [sendRC6()
+// stops at 32 bits]; Each is captured by the library's own receiver, the
+// detector seeing the LED.  Then PRESSES presses of each, every duration off
+// by up to the jitter either way, are decoded by decodeSpan() with the
+// protocol locked, and by the old decoders, which read the frame a half-bit
+// at a time with getRClevel() [they are copied here as they were].
+// The two must accept the same presses, as the same bits, and every press
+// without jitter must decode as sent.  The old value, a long of 64 bits on
+// this PC, holds all 36 bits of an MCE frame : The new one must hold the last
+// 32 and address the 4 before them.  Prints how many presses each decoded and
+// the time per frame on this PC [make manchester, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+#include "sim.h"
+
+#include <time.h>
+
+#if IR_ECHO_MUTE
+#	error "Build it with -DIR_ECHO_MUTE=0 : The receiver captures the LED"
+#endif
+
+#define PRESSES  2000  // Per frame and jitter
+
+#define RC5_T1         889
+#define RC6_HDR_MARK  2666
+#define RC6_HDR_SPACE  889
+#define RC6_T1         444
+
+typedef
+	struct {
+		decode_type_t       type;
+		unsigned long long  value;
+		int                 bits;
+		irraw_t             raw[RAWBUF];  // Gap first, in ticks
+		int                 len;
+	}
+frame_t;
+
+IRrecv          irrecv(11);
+IRsend          irsend;
+decode_results  results;
+
+static frame_t  frames[] = {
+	{RC5, 0x80C,          12},
+	{RC5, 0x123,          12},
+	{RC5, 0xFFF,          12},
+	{RC6, 0x1000C,        20},
+	{RC6, 0xFFFFF,        20},
+	{RC6, 0xC800F040CULL, 36},
+	{RC6, 0xC800F840CULL, 36},
+	{RC6, 0xFFFFFFFFFULL, 36},
+};
+#define FRAMES  (sizeof(frames) / sizeof(frames[0]))
+
+//+=============================================================================
+// The old decoders : A level at a time, each duration matched to 1, 2 or 3
+// times t1 again for every half-bit in it
+//
+static int  oldGetRClevel (decode_results *results,  int *offset,  int *used,  int t1)
+{
+	int  width;
+	int  val;
+	int  correction;
+	int  avail;
+
+	if (*offset >= results->rawlen)  return SPACE ;  // After end of recorded buffer, assume SPACE.
+	width      = results->rawAt(*offset);
+	val        = ((*offset) % 2) ? MARK : SPACE;
+	correction = (val == MARK) ? MARK_EXCESS : - MARK_EXCESS;
+
+	if      (MATCH(width, (  t1) + correction))  avail = 1 ;
+	else if (MATCH(width, (2*t1) + correction))  avail = 2 ;
+	else if (MATCH(width, (3*t1) + correction))  avail = 3 ;
+	else                                         return -1 ;
+
+	(*used)++;
+	if (*used >= avail) {
+		*used = 0;
+		(*offset)++;
+	}
+	return val;
+}
+
+static bool  oldDecodeRC5 (decode_results *results)
+{
+	int   nbits;
+	long  data   = 0;
+	int   used   = 0;
+	int   offset = 1;  // Skip gap space
+
+	if (results->rawlen < 11 + 2)  return false ;
+
+	// Get start bits
+	if (oldGetRClevel(results, &offset, &used, RC5_T1) != MARK)   return false ;
+	if (oldGetRClevel(results, &offset, &used, RC5_T1) != SPACE)  return false ;
+	if (oldGetRClevel(results, &offset, &used, RC5_T1) != MARK)   return false ;
+
+	for (nbits = 0;  offset < results->rawlen;  nbits++) {
+		int  levelA = oldGetRClevel(results, &offset, &used, RC5_T1);
+		int  levelB = oldGetRClevel(results, &offset, &used, RC5_T1);
+
+		if      ((levelA == SPACE) && (levelB == MARK ))  data = (data << 1) | 1 ;
+		else if ((levelA == MARK ) && (levelB == SPACE))  data = (data << 1) | 0 ;
+		else                                              return false ;
+	}
+
+	results->bits        = nbits;
+	results->value       = data;
+	results->decode_type = RC5;
+	return true;
+}
+
+static bool  oldDecodeRC6 (decode_results *results)
+{
+	int   nbits;
+	long  data   = 0;
+	int   used   = 0;
+	int   offset = 1;  // Skip first space
+
+	// Initial mark
+	if (!MATCH_MARK(results->rawAt(offset++),  RC6_HDR_MARK))   return false ;
+	if (!MATCH_SPACE(results->rawAt(offset++), RC6_HDR_SPACE))  return false ;
+
+	// Get start bit (1)
+	if (oldGetRClevel(results, &offset, &used, RC6_T1) != MARK)   return false ;
+	if (oldGetRClevel(results, &offset, &used, RC6_T1) != SPACE)  return false ;
+
+	for (nbits = 0;  offset < results->rawlen;  nbits++) {
+		int  levelA, levelB;  // Next two levels
+
+		levelA = oldGetRClevel(results, &offset, &used, RC6_T1);
+		if (nbits == 3) {
+			// T bit is double wide; make sure second half matches
+			if (levelA != oldGetRClevel(results, &offset, &used, RC6_T1)) return false;
+		}
+
+		levelB = oldGetRClevel(results, &offset, &used, RC6_T1);
+		if (nbits == 3) {
+			// T bit is double wide; make sure second half matches
+			if (levelB != oldGetRClevel(results, &offset, &used, RC6_T1)) return false;
+		}
+
+		if      ((levelA == MARK ) && (levelB == SPACE))  data = (data << 1) | 1 ;  // inverted compared to RC5
+		else if ((levelA == SPACE) && (levelB == MARK ))  data = (data << 1) | 0 ;  // ...
+		else                                              return false ;            // Error
+	}
+
+	results->bits        = nbits;
+	results->value       = data;
+	results->decode_type = RC6;
+	return true;
+}
+
+//+=============================================================================
+// An RC6 frame of any length, as sendRC6() would send it, in uS
+//
+static int  rc6Frame (unsigned long long value,  int nbits,  unsigned int *usec)
+{
+	int  len = 0;
+
+	// Half a bit at a time; The same level again lengthens the last duration
+	auto  half = [&] (int level,  unsigned int us) {
+		if (len && ((((len - 1) & 1) ? SPACE : MARK) == level))  usec[len - 1] += us ;
+		else                                                      usec[len++] = us ;
+	};
+
+	half(MARK,  RC6_HDR_MARK);
+	half(SPACE, RC6_HDR_SPACE);
+	half(MARK,  RC6_T1);  // Start bit
+	half(SPACE, RC6_T1);
+	for (int i = nbits - 1;  i >= 0;  i--) {
+		unsigned int  t   = (i == nbits - 4) ? (2 * RC6_T1) : RC6_T1;  // The trailer bit is double width
+		bool          one = (value >> i) & 1;
+
+		half(one ? MARK  : SPACE, t);
+		half(one ? SPACE : MARK,  t);
+	}
+	if (!(len & 1))  len-- ;  // The last SPACE is the gap
+	return len;
+}
+
+//+=============================================================================
+// Send frame f, and keep what the receiver captured of it
+//
+static bool  record (frame_t *f)
+{
+	unsigned int  usec[2 + 2 * 40];
+
+	if      (f->type == RC5)  irsend.sendRC5(f->value, f->bits) ;
+	else if (f->bits <= 32)   irsend.sendRC6(f->value, f->bits) ;
+	else                      irsend.sendRaw(usec, rc6Frame(f->value, f->bits, usec), 36) ;
+	simRun(50000);
+
+	if (!irrecv.capture(&results))  return false ;
+	for (int i = 0;  i < results.rawlen;  i++)  f->raw[i] = results.rawAt(i) ;
+	f->len = results.rawlen;
+	irrecv.resume();
+	return true;
+}
+
+//+=============================================================================
+// nS on this PC's clock [micros() is the simulation's]
+//
+static unsigned long  wallNanos ( )
+{
+	struct timespec  now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000UL + now.tv_nsec;
+}
+
+//+=============================================================================
+// A press of frame f, each duration off by up to jitter percent
+//
+static void  press (const frame_t *f,  int jitter,  irraw_t *raw)
+{
+	for (int i = 0;  i < f->len;  i++) {
+		long  ticks = f->raw[i];
+
+		if (i)  ticks += (ticks * random(-jitter, jitter + 1) + 50) / 100 ;
+		raw[i] = (ticks < 1) ? 1 : ticks;
+	}
+}
+
+//+=============================================================================
+int  main ( )
+{
+	static irraw_t  raw[RAWBUF];
+	bool            ok = true;
+
+	simStart();
+	simEcho = true;
+	irrecv.enableIRIn();
+	simRun(50000);
+	for (unsigned int k = 0;  k < FRAMES;  k++) {
+		if (!record(&frames[k])) {
+			printf("Frame %u was not captured\n", k);
+			return 1;
+		}
+	}
+
+	randomSeed(1);
+	printf("  jitter  frame               decoded : old     new     differ   nS/frame : old  new\n");
+	for (int jitter = 0;  jitter <= 20;  jitter += 10) {
+		for (unsigned int k = 0;  k < FRAMES;  k++) {
+			const frame_t  *f      = &frames[k];
+			unsigned long   oldOk  = 0,  newOk = 0,  differ = 0,  ns = 0,  nsOld = 0;
+
+			irrecv.lockProtocol(f->type);
+			for (int n = 0;  n < PRESSES;  n++) {
+				unsigned long  start, value;
+				unsigned int   address;
+				int            bits;
+				bool           decoded, oldDecoded;
+
+				press(f, jitter, raw);
+
+				start   = wallNanos();
+				decoded = irrecv.decodeSpan(&results, raw, f->len);
+				ns     += wallNanos() - start;
+				value   = results.value;
+				address = results.address;
+				bits    = results.bits;
+
+				start      = wallNanos();
+				oldDecoded = (f->type == RC5) ? oldDecodeRC5(&results) : oldDecodeRC6(&results);
+				nsOld     += wallNanos() - start;
+
+				oldOk += oldDecoded;
+				newOk += decoded;
+				if (decoded != oldDecoded) {
+					differ++;
+				} else if (decoded) {
+					unsigned long long  all = results.value;  // All the bits, in a long of 64
+
+					if ((bits != results.bits) || ((uint32_t)value != (uint32_t)all) || ((bits > 32) && (address != (all >> 32))))
+						differ++;
+				}
+				if (!jitter && (!decoded || ((((bits > 32) ? (unsigned long long)address << 32 : 0) | (uint32_t)value) != f->value)))  differ++ ;
+			}
+
+			printf("  +-%2d%%   RC%d %2d bits %9llX   %5.1f%%  %5.1f%%  %5lu              %5lu %5lu\n", jitter,
+			       (f->type == RC5) ? 5 : 6, f->bits, f->value, 100.0 * oldOk / PRESSES, 100.0 * newOk / PRESSES,
+			       differ, nsOld / PRESSES, ns / PRESSES);
+			if (differ)  ok = false ;
+		}
+	}
+
+	printf("%s\n", ok ? "The same presses decoded as the same bits, and MCE frames in full"
+	                  : "FAILED : The decoders differ, or a press without jitter did not decode as sent");
+	return ok ? 0 : 1;
+}
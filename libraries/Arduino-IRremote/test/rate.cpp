@@ -0,0 +1,104 @@
+//******************************************************************************
+// Rate test : Between frames the timer ISR runs at a quarter of the rate,
+// and frames decode as they do at the full rate [IR_ADAPTIVE_RATE]
+//
+// On the virtual Timer2 of sim.h, the receiver is left alone for a quiet
+// second, and its timer interrupts counted : One per USECPERTICK, or per
+// TIMER_IDLE_TICKS of them with IR_ADAPTIVE_RATE.  The remote then sends
+// each of the IRbench captures, 50mS apart, and each must decode as
+// captured.  A capture that should only hash is right if it hashes as it does
+// when decoded as it is [as IRbench checks them].  Build it with and without
+// IR_ADAPTIVE_RATE to compare them [make rate, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+#include "sim.h"
+
+#if IR_RECV_EDGE
+#	error "Build it without IR_RECV_EDGE : It times the timer ISR"
+#endif
+
+typedef
+	struct {
+		int8_t               type;    // What it should decode as
+		unsigned long        value;
+		const unsigned int  *timing;  // uS, as IRrecvDumpV2 prints them
+		uint8_t              len;
+	}
+capture_t;
+
+#include "../examples/IRbench/captures.h"
+
+#if IR_ADAPTIVE_RATE
+#	define QUIET_ISRS  (1000000UL / (USECPERTICK * TIMER_IDLE_TICKS))
+#else
+#	define QUIET_ISRS  (1000000UL / USECPERTICK)
+#endif
+
+IRrecv          irrecv(11);
+decode_results  results;
+
+//+=============================================================================
+// What the capture decodes as, as it is : Its durations, after a 50mS gap
+//
+static void  expect (const capture_t *cap,  decode_results *results)
+{
+	irraw_t  buf[RAWBUF];
+	int      len = 0;
+
+	buf[len++] = 50000 / USECPERTICK;
+	for (int i = 0;  (i < cap->len) && (len < RAWBUF);  i++)  buf[len++] = cap->timing[i] / USECPERTICK ;
+	irrecv.decodeSpan(results, buf, len);
+}
+
+//+=============================================================================
+int  main ( )
+{
+	unsigned long  quiet, t;
+	int            same = 0;
+	bool           ok   = true;
+
+	simStart();
+	irrecv.enableIRIn();
+	simRun(50000);
+
+	// A quiet second
+	quiet = simIsrs;
+	simRun(1000000);
+	quiet = simIsrs - quiet;
+
+	// The captures, 50mS apart
+	for (unsigned int c = 0;  c < CAPTURES;  c++) {
+		const capture_t  *cap   = &captures[c];
+		unsigned long     value = cap->value;
+		bool              seen  = false;
+
+		// UNKNOWN : Its hash
+		if (cap->type == UNKNOWN) {
+			expect(cap, &results);
+			value = results.value;
+		}
+
+		t = simRemote(micros() + 1000, cap->timing, cap->len) + 50000;
+		while (micros() < t) {
+			simRun(1000);
+			if (!irrecv.decode(&results))  continue ;
+
+			if (!seen && (results.decode_type == cap->type) && ((uint32_t)results.value == (uint32_t)value)) {
+				seen = true;
+				same++;
+			} else {
+				printf("%2u : type %2d value %8lX -> type %2d value %8lX\n", c, cap->type, (unsigned long)(uint32_t)value,
+				       results.decode_type, (unsigned long)(uint32_t)results.value);
+			}
+			irrecv.resume();
+		}
+		if (!seen)  printf("%2u : type %2d value %8lX -> nothing\n", c, cap->type, (unsigned long)(uint32_t)value) ;
+	}
+
+	printf("IR_ADAPTIVE_RATE %d : %lu interrupts in a quiet second [%lu expected], %d of %u as captured\n",
+	       IR_ADAPTIVE_RATE, quiet, QUIET_ISRS, same, (unsigned int)CAPTURES);
+	if ((quiet < QUIET_ISRS - QUIET_ISRS / 100) || (quiet > QUIET_ISRS + QUIET_ISRS / 100))  ok = false ;
+	if (same != (int)CAPTURES)                                                             ok = false ;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+//******************************************************************************
+// Relay test : Frames captured while relaying go straight back out of the LED,
+// as they came in and soon after they end [IRrecv::relay()]
+//
+// On the virtual Timer2 of sim.h, a remote sends 30 NEC frames, 6mS apart
+// [faster than a real one repeats], while the sketch only relays them.
+//   shielded : Built with IR_ECHO_MUTE 0, the detector not seeing the LED.  A
+//              frame comes in while the one before it goes out, so with one
+//              capture slot every other frame is dropped [and counted], and
+//              with two or more none are.
+//   mute     : Built with IR_ECHO_MUTE, the detector seeing the LED.  The
+//              relay is half duplex : Every other frame is lost to the mute,
+//              and the LED is never relayed back to itself.
+// Each frame relayed must start within LATENCY_MIN..LATENCY_MAX uS of the end
+// of the frame it repeats, and each of its MARKs and SPACEs be within
+// ERROR_LIMIT uS of the remote's, with the MARK_EXCESS correction ["raw" :
+// Without it, MARK_EXCESS more].  capture() must see nothing.  Prints the latency and the worst error [make relay, see
+// the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+#include "sim.h"
+
+#if !IR_SEND_ASYNC
+#	error "Build it with -DIR_SEND_ASYNC=1"
+#endif
+
+#define FRAMES       30
+#define FRAME_GAP    6000   // uS from the end of one frame to the next
+#define FRAME_LEN    67     // NEC : 34 MARKs and the SPACEs between them
+#define LATENCY_MIN  _GAP   // The receiver only ends a frame after _GAP
+#define LATENCY_MAX  (_GAP + 1000)
+#define KHZ          38
+#define ERROR_LIMIT  (2 * USECPERTICK + 1000 / KHZ)  // A tick each end, and a carrier period
+
+IRrecv          irrecv(11);
+decode_results  results;
+
+//+=============================================================================
+// An NEC frame in uS, MARK first
+//
+static int  nec (unsigned int *usec,  unsigned long value)
+{
+	int  len = 0;
+
+	usec[len++] = 9000;
+	usec[len++] = 4500;
+	for (int i = 31;  i >= 0;  i--) {
+		usec[len++] = 560;
+		usec[len++] = ((value >> i) & 1) ? 1690 : 560;
+	}
+	usec[len++] = 560;
+	return len;
+}
+
+//+=============================================================================
+int  main (int argc,  char *argv[])
+{
+	static unsigned int   frame[FRAMES][FRAME_LEN];
+	static unsigned long  got[SIM_LED_EDGES];
+	static bool           relayed[FRAMES];
+	unsigned long         end[FRAMES], t;
+	bool                  excess = !((argc > 1) && !strcmp(argv[1], "raw"));
+	long                  limit  = ERROR_LIMIT + (excess ? 0 : MARK_EXCESS);
+	long                  worst  = 0,  latMin = 0,  latMax = 0;
+	int                   frames = 0,  captures = 0,  want,  gots;
+	bool                  ok     = true;
+
+	simStart();
+	simEcho = IR_ECHO_MUTE;  // Without the mute, shield the detector from the LED
+
+	t = 20000;
+	for (int f = 0;  f < FRAMES;  f++) {
+		nec(frame[f], 0x20DF10EFUL ^ (f * 0x01010101UL));
+		end[f]   = simRemote(t, frame[f], FRAME_LEN);
+		t        = end[f] + FRAME_GAP;
+	}
+
+	printf("IR_CAPTURE_SLOTS %d, IR_ECHO_MUTE %d, detector %s, %s :\n", IR_CAPTURE_SLOTS, IR_ECHO_MUTE,
+	       simEcho ? "sees the LED" : "shielded", excess ? "corrected for MARK_EXCESS" : "raw");
+
+	irrecv.enableIRIn();
+	irrecv.relay(KHZ, excess);
+	while (micros() < end[FRAMES - 1] + 100000) {
+		simRun(100);
+		if (irrecv.capture(&results))  { captures++;  irrecv.resume(); }
+	}
+
+	// Split the LED in to frames, and match each to the last one the remote
+	// had ended by then
+	gots = simWave(0, got, SIM_LED_EDGES);
+	for (int e = 0;  e < simLedEdges;  e += FRAME_LEN + 1) {
+		unsigned long  at = simLedAt[e];
+		long           lat;
+		int            f;
+
+		for (f = FRAMES - 1;  (f >= 0) && (end[f] > at);  f--) ;
+		if ((f < 0) || relayed[f] || (e + FRAME_LEN > gots) || ((e + FRAME_LEN < gots) && (got[e + FRAME_LEN] < _GAP))) {
+			printf("  The LED at %lu uS is no frame of the remote's\n", at);
+			ok = false;
+			break;
+		}
+		relayed[f] = true;
+		frames++;
+
+		lat = at - end[f];
+		if (!latMin || (lat < latMin))  latMin = lat ;
+		if (lat > latMax)               latMax = lat ;
+		for (int i = 0;  i < FRAME_LEN;  i++) {
+			long  err = (long)got[e + i] - (long)frame[f][i];
+
+			if (labs(err) > labs(worst))  worst = err ;
+		}
+	}
+
+	// Every frame with two or more slots and shielded; Else every other one
+	want = (IR_CAPTURE_SLOTS > 1 && !IR_ECHO_MUTE) ? FRAMES : FRAMES / 2;
+	printf("  %d/%d frames relayed, %u dropped; latency %ld..%ld uS; worst MARK/SPACE error %+ld uS\n",
+	       frames, FRAMES, irrecv.dropped(), latMin, latMax, worst);
+	if (frames != want) {
+		printf("  %d frames should have been relayed\n", want);
+		ok = false;
+	}
+	if (irrecv.dropped() != (IR_ECHO_MUTE ? 0U : (unsigned int)(FRAMES - want))) {
+		printf("  Dropped frames were not counted, or frames were dropped from a free slot\n");
+		ok = false;
+	}
+	if (frames && ((latMin < LATENCY_MIN) || (latMax > LATENCY_MAX) || (labs(worst) > limit))) {
+		printf("  Relayed too late, or the error is over %ld uS\n", limit);
+		ok = false;
+	}
+	if (captures) {
+		printf("  capture() saw %d frames while relaying\n", captures);
+		ok = false;
+	}
+	printf("  %s\n", ok ? "As expected" : "FAILED");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,560 @@
+//******************************************************************************
+// Send test : The encoder senders send what the hand-written ones did
+//
+// The senders as they were before IRencoder are below, as they were but for
+// mark(), space(), enableIROut() and delay() : These note what was asked of
+// them, with MARKs or SPACEs that follow each other run together [the LED
+// stays as it is in between].  The library's senders are run on a stopped
+// clock, and the LED [COM2B1] is watched each uS.  send() gives each duration
+// to custom_delay_usec(), which ends 3uS short here [each micros() call takes
+// a uS], so 3uS are added back to each.  The carrier is compared as OCR2A.
+// Each protocol is sent with a few values, and must match exactly.  What the
+// encoders were meant to change does not show here : Halves at the same level
+// were back to back before [RC5, RC6], a last MARK is the same whether the LED
+// is then turned off or not [DISH], and Aiwa is sent as on AVR [int of 16 bits].
+// LEGO is not here : Its encoder changed with its sender.
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+#define DURATIONS  400
+
+typedef
+	struct {
+		unsigned long  usec[DURATIONS];  // MARK first
+		int            len;
+		uint8_t        ocr;              // Carrier, as OCR2A
+	}
+wave_t;
+
+static wave_t  wave;
+
+//+=============================================================================
+// Add a MARK or SPACE to the wave, running it in to the last at that level
+//
+static void  add (bool mark,  unsigned long usec)
+{
+	if (!usec)  return ;
+	if (!wave.len && !mark)  return ;  // The LED was off before the frame anyway
+	if ((wave.len & 1) != mark)  wave.len++ ;
+	if (wave.len <= DURATIONS)  wave.usec[wave.len - 1] += usec ;
+}
+
+//==============================================================================
+// The senders before IRencoder [int is 16 bits, as on AVR]
+//
+#define NEC_HDR_MARK    9000
+#define NEC_HDR_SPACE   4500
+#define NEC_BIT_MARK     560
+#define NEC_ONE_SPACE   1690
+#define NEC_ZERO_SPACE   560
+
+#define SONY_HDR_MARK   2400
+#define SONY_HDR_SPACE   600
+#define SONY_ONE_MARK   1200
+#define SONY_ZERO_MARK   600
+
+#define RC5_T1           889
+#define RC6_HDR_MARK    2666
+#define RC6_HDR_SPACE    889
+#define RC6_T1           444
+
+#define PANASONIC_HDR_MARK    3502
+#define PANASONIC_HDR_SPACE   1750
+#define PANASONIC_BIT_MARK     502
+#define PANASONIC_ONE_SPACE   1244
+#define PANASONIC_ZERO_SPACE   400
+
+#define JVC_HDR_MARK     8000
+#define JVC_HDR_SPACE    4000
+#define JVC_BIT_MARK      600
+#define JVC_ONE_SPACE    1600
+#define JVC_ZERO_SPACE    550
+
+#define SAMSUNG_HDR_MARK    5000
+#define SAMSUNG_HDR_SPACE   5000
+#define SAMSUNG_BIT_MARK     560
+#define SAMSUNG_ONE_SPACE   1600
+#define SAMSUNG_ZERO_SPACE   560
+
+#define WHYNTER_HDR_MARK    2850
+#define WHYNTER_HDR_SPACE   2850
+#define WHYNTER_ONE_MARK     750
+#define WHYNTER_ONE_SPACE   2150
+#define WHYNTER_ZERO_MARK    750
+#define WHYNTER_ZERO_SPACE   750
+
+#define AIWA_RC_T501_HZ            38
+#define AIWA_RC_T501_HDR_MARK    8800
+#define AIWA_RC_T501_HDR_SPACE   4500
+#define AIWA_RC_T501_BIT_MARK     500
+#define AIWA_RC_T501_ONE_SPACE    600
+#define AIWA_RC_T501_ZERO_SPACE  1700
+
+#define LG_HDR_MARK     8000
+#define LG_HDR_SPACE    4000
+#define LG_BIT_MARK      600
+#define LG_ONE_SPACE    1600
+#define LG_ZERO_SPACE    550
+
+#define DISH_HDR_MARK     400
+#define DISH_HDR_SPACE   6100
+#define DISH_BIT_MARK     400
+#define DISH_ONE_SPACE   1700
+#define DISH_ZERO_SPACE  2800
+
+#define SHARP_BIT_MARK        245
+#define SHARP_ONE_SPACE      1805
+#define SHARP_ZERO_SPACE      795
+#define SHARP_TOGGLE_MASK  0x3FF
+
+#define DENON_HDR_MARK     300
+#define DENON_HDR_SPACE    750
+#define DENON_BIT_MARK     300
+#define DENON_ONE_SPACE   1800
+#define DENON_ZERO_SPACE   750
+
+class OldSend
+{
+	public:
+		void  mark        (uint16_t time)  { add(true,  time); }
+		void  space       (uint16_t time)  { add(false, time); }
+		void  delay       (unsigned long ms)  { space(0);  add(false, ms * 1000); }
+		void  enableIROut (int khz)  { wave.ocr = SYSCLOCK / 2000 / khz; }
+
+		void  sendNEC (unsigned long data,  int nbits)
+		{
+			// Set IR carrier frequency
+			enableIROut(38);
+
+			// Header
+			mark(NEC_HDR_MARK);
+			space(NEC_HDR_SPACE);
+
+			// Data
+			for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
+				if (data & mask) {
+					mark(NEC_BIT_MARK);
+					space(NEC_ONE_SPACE);
+				} else {
+					mark(NEC_BIT_MARK);
+					space(NEC_ZERO_SPACE);
+				}
+			}
+
+			// Footer
+			mark(NEC_BIT_MARK);
+			space(0);  // Always end with the LED off
+		}
+
+		void  sendSony (unsigned long data,  int nbits)
+		{
+			// Set IR carrier frequency
+			enableIROut(40);
+
+			// Header
+			mark(SONY_HDR_MARK);
+			space(SONY_HDR_SPACE);
+
+			// Data
+			for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
+				if (data & mask) {
+					mark(SONY_ONE_MARK);
+					space(SONY_HDR_SPACE);
+				} else {
+					mark(SONY_ZERO_MARK);
+					space(SONY_HDR_SPACE);
+				}
+			}
+
+			// We will have ended with LED off
+		}
+
+		void  sendRC5 (unsigned long data,  int nbits)
+		{
+			// Set IR carrier frequency
+			enableIROut(36);
+
+			// Start
+			mark(RC5_T1);
+			space(RC5_T1);
+			mark(RC5_T1);
+
+			// Data
+			for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
+				if (data & mask) {
+					space(RC5_T1); // 1 is space, then mark
+					mark(RC5_T1);
+				} else {
+					mark(RC5_T1);
+					space(RC5_T1);
+				}
+			}
+
+			space(0);  // Always end with the LED off
+		}
+
+		void  sendRC6 (unsigned long data,  int nbits)
+		{
+			// Set IR carrier frequency
+			enableIROut(36);
+
+			// Header
+			mark(RC6_HDR_MARK);
+			space(RC6_HDR_SPACE);
+
+			// Start bit
+			mark(RC6_T1);
+			space(RC6_T1);
+
+			// Data
+			for (unsigned long  i = 1, mask = 1UL << (nbits - 1);  mask;  i++, mask >>= 1) {
+				// The fourth bit we send is a "double width trailer bit"
+				int16_t  t = (i == 4) ? (RC6_T1 * 2) : (RC6_T1) ;
+				if (data & mask) {
+					mark(t);
+					space(t);
+				} else {
+					space(t);
+					mark(t);
+				}
+			}
+
+			space(0);  // Always end with the LED off
+		}
+
+		void  sendPanasonic (uint16_t address,  unsigned long data)
+		{
+			// Set IR carrier frequency
+			enableIROut(35);
+
+			// Header
+			mark(PANASONIC_HDR_MARK);
+			space(PANASONIC_HDR_SPACE);
+
+			// Address
+			for (unsigned long  mask = 1UL << (16 - 1);  mask;  mask >>= 1) {
+				mark(PANASONIC_BIT_MARK);
+				if (address & mask)  space(PANASONIC_ONE_SPACE) ;
+				else                 space(PANASONIC_ZERO_SPACE) ;
+			}
+
+			// Data
+			for (unsigned long  mask = 1UL << (32 - 1);  mask;  mask >>= 1) {
+				mark(PANASONIC_BIT_MARK);
+				if (data & mask)  space(PANASONIC_ONE_SPACE) ;
+				else              space(PANASONIC_ZERO_SPACE) ;
+			}
+
+			// Footer
+			mark(PANASONIC_BIT_MARK);
+			space(0);  // Always end with the LED off
+		}
+
+		void  sendJVC (unsigned long data,  int nbits,  bool repeat)
+		{
+			// Set IR carrier frequency
+			enableIROut(38);
+
+			// Only send the Header if this is NOT a repeat command
+			if (!repeat){
+				mark(JVC_HDR_MARK);
+				space(JVC_HDR_SPACE);
+			}
+
+			// Data
+			for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
+				if (data & mask) {
+					mark(JVC_BIT_MARK);
+					space(JVC_ONE_SPACE);
+				} else {
+					mark(JVC_BIT_MARK);
+					space(JVC_ZERO_SPACE);
+				}
+			}
+
+			// Footer
+			mark(JVC_BIT_MARK);
+			space(0);  // Always end with the LED off
+		}
+
+		void  sendSAMSUNG (unsigned long data,  int nbits)
+		{
+			// Set IR carrier frequency
+			enableIROut(38);
+
+			// Header
+			mark(SAMSUNG_HDR_MARK);
+			space(SAMSUNG_HDR_SPACE);
+
+			// Data
+			for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
+				if (data & mask) {
+					mark(SAMSUNG_BIT_MARK);
+					space(SAMSUNG_ONE_SPACE);
+				} else {
+					mark(SAMSUNG_BIT_MARK);
+					space(SAMSUNG_ZERO_SPACE);
+				}
+			}
+
+			// Footer
+			mark(SAMSUNG_BIT_MARK);
+			space(0);  // Always end with the LED off
+		}
+
+		void  sendWhynter (unsigned long data,  int nbits)
+		{
+			// Set IR carrier frequency
+			enableIROut(38);
+
+			// Start
+			mark(WHYNTER_ZERO_MARK);
+			space(WHYNTER_ZERO_SPACE);
+
+			// Header
+			mark(WHYNTER_HDR_MARK);
+			space(WHYNTER_HDR_SPACE);
+
+			// Data
+			for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
+				if (data & mask) {
+					mark(WHYNTER_ONE_MARK);
+					space(WHYNTER_ONE_SPACE);
+				} else {
+					mark(WHYNTER_ZERO_MARK);
+					space(WHYNTER_ZERO_SPACE);
+				}
+			}
+
+			// Footer
+			mark(WHYNTER_ZERO_MARK);
+			space(WHYNTER_ZERO_SPACE);  // Always end with the LED off
+		}
+
+		void  sendAiwaRCT501 (int16_t code)
+		{
+			unsigned long  pre = 0x0227EEC0;  // 26-bits
+
+			// Set IR carrier frequency
+			enableIROut(AIWA_RC_T501_HZ);
+
+			// Header
+			mark(AIWA_RC_T501_HDR_MARK);
+			space(AIWA_RC_T501_HDR_SPACE);
+
+			// Send "pre" data
+			for (unsigned long  mask = 1UL << (26 - 1);  mask;  mask >>= 1) {
+				mark(AIWA_RC_T501_BIT_MARK);
+				if (pre & mask)  space(AIWA_RC_T501_ONE_SPACE) ;
+				else             space(AIWA_RC_T501_ZERO_SPACE) ;
+			}
+
+			// Skip first code bit
+			code <<= 1;
+			// Send code
+			for (int  i = 0;  i < 15;  i++) {
+				mark(AIWA_RC_T501_BIT_MARK);
+				if (code & 0x80000000)  space(AIWA_RC_T501_ONE_SPACE) ;
+				else                    space(AIWA_RC_T501_ZERO_SPACE) ;
+				code <<= 1;
+			}
+
+			// POST-DATA, 1 bit, 0x0
+			mark(AIWA_RC_T501_BIT_MARK);
+			space(AIWA_RC_T501_ZERO_SPACE);
+
+			mark(AIWA_RC_T501_BIT_MARK);
+			space(0);
+		}
+
+		void  sendLG (unsigned long data,  int nbits)
+		{
+			// Set IR carrier frequency
+			enableIROut(38);
+
+			// Header
+			mark(LG_HDR_MARK);
+			space(LG_HDR_SPACE);
+			mark(LG_BIT_MARK);
+
+			// Data
+			for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
+				if (data & mask) {
+					space(LG_ONE_SPACE);
+					mark(LG_BIT_MARK);
+				} else {
+					space(LG_ZERO_SPACE);
+					mark(LG_BIT_MARK);
+				}
+			}
+			space(0);  // Always end with the LED off
+		}
+
+		void  sendDISH (unsigned long data,  int nbits)
+		{
+			// Set IR carrier frequency
+			enableIROut(56);
+
+			mark(DISH_HDR_MARK);
+			space(DISH_HDR_SPACE);
+
+			for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
+				if (data & mask) {
+					mark(DISH_BIT_MARK);
+					space(DISH_ONE_SPACE);
+				} else {
+					mark(DISH_BIT_MARK);
+					space(DISH_ZERO_SPACE);
+				}
+			}
+			mark(DISH_HDR_MARK); //added 26th March 2016, by AnalysIR ( https://www.AnalysIR.com )
+		}
+
+		void  sendSharpRaw (unsigned long data,  int nbits)
+		{
+			enableIROut(38);
+
+			// Sending codes in bursts of 3 (normal, inverted, normal) makes transmission
+			// much more reliable. That's the exact behaviour of CD-S6470 remote control.
+			for (int n = 0;  n < 3;  n++) {
+				for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
+					if (data & mask) {
+						mark(SHARP_BIT_MARK);
+						space(SHARP_ONE_SPACE);
+					} else {
+						mark(SHARP_BIT_MARK);
+						space(SHARP_ZERO_SPACE);
+					}
+				}
+
+				mark(SHARP_BIT_MARK);
+				space(SHARP_ZERO_SPACE);
+				delay(40);
+
+				data = data ^ SHARP_TOGGLE_MASK;
+			}
+		}
+
+		void  sendDenon (unsigned long data,  int nbits)
+		{
+			// Set IR carrier frequency
+			enableIROut(38);
+
+			// Header
+			mark (DENON_HDR_MARK);
+			space(DENON_HDR_SPACE);
+
+			// Data
+			for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
+				if (data & mask) {
+					mark (DENON_BIT_MARK);
+					space(DENON_ONE_SPACE);
+				} else {
+					mark (DENON_BIT_MARK);
+					space(DENON_ZERO_SPACE);
+				}
+			}
+
+			// Footer
+			mark(DENON_BIT_MARK);
+			space(0);  // Always end with the LED off
+		}
+};
+
+//==============================================================================
+// The library's senders, through the LED
+//
+static bool           led;
+static unsigned long  edge;  // uS the LED last changed
+
+static void  watch (unsigned long usec)
+{
+	bool  on = TCCR2A & _BV(COM2B1);
+
+	if (on == led)  return ;
+	add(led, usec - edge + 3);  // custom_delay_usec() ends 3uS short
+	led  = on;
+	edge = usec;
+}
+
+//+=============================================================================
+// Each sender, old and new
+//
+enum { TX_NEC, TX_SONY12, TX_SONY20, TX_RC5, TX_RC6, TX_PANASONIC, TX_JVC, TX_JVC_RPT, TX_SAMSUNG, TX_WHYNTER, TX_AIWA, TX_LG, TX_DISH, TX_SHARP, TX_DENON, TX_SENDERS };
+
+static const char * const  names[TX_SENDERS] = {
+	"NEC", "SONY12", "SONY20", "RC5", "RC6", "PANASONIC", "JVC", "JVC_RPT", "SAMSUNG", "WHYNTER",
+	"AIWA", "LG", "DISH", "SHARP", "DENON"
+};
+
+template <class T>
+static void  send (T *s,  int sender,  unsigned long v)
+{
+	switch (sender) {
+		case TX_NEC       :  s->sendNEC(v, 32);                       break;
+		case TX_SONY12    :  s->sendSony(v & 0xFFF, 12);              break;
+		case TX_SONY20    :  s->sendSony(v & 0xFFFFF, 20);            break;
+		case TX_RC5       :  s->sendRC5(v & 0xFFF, 12);               break;
+		case TX_RC6       :  s->sendRC6(v & 0xFFFFF, 20);             break;
+		case TX_PANASONIC :  s->sendPanasonic(v >> 16, v);            break;
+		case TX_JVC       :  s->sendJVC(v & 0xFFFF, 16, false);       break;
+		case TX_JVC_RPT   :  s->sendJVC(v & 0xFFFF, 16, true);        break;
+		case TX_SAMSUNG   :  s->sendSAMSUNG(v, 32);                   break;
+		case TX_WHYNTER   :  s->sendWhynter(v, 32);                   break;
+		case TX_AIWA      :  s->sendAiwaRCT501(v & 0xFFFF);           break;
+		case TX_LG        :  s->sendLG(v & 0xFFFFFFF, 28);            break;
+		case TX_DISH      :  s->sendDISH(v & 0xFFFF, 16);             break;
+		case TX_SHARP     :  s->sendSharpRaw(v & 0x7FFF, 15);         break;
+		case TX_DENON     :  s->sendDenon(v & 0x3FFF, 14);            break;
+	}
+}
+
+//+=============================================================================
+static void  show (const char *what,  const wave_t *w)
+{
+	printf("  %s [OCR2A %u] :", what, w->ocr);
+	for (int i = 0;  i < w->len;  i++)  printf(" %c%lu", (i & 1) ? '-' : '+', w->usec[i]) ;
+	printf("\n");
+}
+
+//+=============================================================================
+int  main ( )
+{
+	static const unsigned long  values[] = {0, 0xFFFFFFFF, 0x12345678, 0xA5A5A5A5, 0x0F0F1E2D};
+	IRsend   irsend;
+	OldSend  oldsend;
+	wave_t   before;
+	unsigned long  end;
+	int      frames = 0, wrong = 0;
+
+	setMicros(0);
+	clockHook = watch;
+
+	for (int sender = 0;  sender < TX_SENDERS;  sender++) {
+		for (unsigned int v = 0;  v < sizeof(values) / sizeof(values[0]);  v++) {
+			memset(&wave, 0, sizeof(wave));
+			send(&oldsend, sender, values[v]);
+			before = wave;
+
+			memset(&wave, 0, sizeof(wave));
+			edge = micros();
+			send(&irsend, sender, values[v]);
+			end = micros() + 1;  // The LED is seen off
+			if (end != edge)  add(false, end - edge + 3) ;  // A SPACE sent before space(0)
+			wave.ocr = OCR2A;
+
+			frames++;
+			if ((before.len != wave.len) || (before.ocr != wave.ocr)
+			    || memcmp(before.usec, wave.usec, sizeof(before.usec[0]) * wave.len)) {
+				printf("%s %08lX differs\n", names[sender], values[v]);
+				show("Before", &before);
+				show("Now   ", &wave);
+				wrong++;
+			}
+		}
+	}
+
+	printf("Senders : %d of %d frames the same as before the encoders\n", frames - wrong, frames);
+	return wrong ? 1 : 0;
+}
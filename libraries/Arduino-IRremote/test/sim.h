@@ -0,0 +1,170 @@
+//******************************************************************************
+// A Nano around the library, a uS at a time, for the simulations in test/
+//
+// Once simStart() stops the clock, each micros() call [the library's busy
+// waits, or simRun()] moves it on a uS, and each uS :
+//   The LED [COM2B1 on pin 3] is logged as it changes.
+//   The receive pin [11] is driven low while the detector sees light : The
+//     remote's MARKs [simRemote()], and the LED if simEcho is set.  Like an
+//     IR detector, it goes low 100uS in to a MARK and high 200uS after it.
+//   In edge mode [IR_RECV_EDGE], a change of the pin runs its interrupt.
+//   Timer2 counts its clocks while its compare interrupt is on, and runs the
+//     ISR once per period : 2 x OCR2A at the carrier [WGM22], or OCR2A
+//     times the prescaler while receiving.
+// Include it in one file of the test, after IRremote.h and IRremoteInt.h.
+//******************************************************************************
+#ifndef sim_h
+#define sim_h
+
+#define SIM_CLOCKS     (SYSCLOCK / 1000000)  // Per uS
+#define SIM_ON_LAG     100                   // uS from light to the pin going low
+#define SIM_OFF_LAG    200                   // uS from dark to the pin going high
+#define SIM_MARKS      2048                  // Remote MARKs waiting
+#define SIM_LED_EDGES  4096                  // LED changes logged
+
+#if !IR_RECV_EDGE || IR_SEND_ASYNC
+extern "C" void  TIMER_INTR_NAME (void) ;
+#	define SIM_TIMER  1
+#else
+#	define SIM_TIMER  0  // No timer ISR at all
+#endif
+#if IR_RECV_EDGE && defined(IR_RECV_PCINT)
+extern "C" void  IR_RECV_PCINT (void) ;
+#endif
+
+unsigned long  simNow;                 // uS simulated so far
+unsigned long  simIsrs;                // Timer interrupts taken
+bool           simEcho;                // The detector sees the LED
+
+static unsigned long  simTarget;       // micros() has got this far
+static unsigned long  simClocks;       // Of Timer2 towards its next interrupt
+static bool           simBusy;         // Stepping [the ISRs call micros() too]
+
+static unsigned long  simMark[SIM_MARKS][2];  // Remote MARKs, from and to, in order
+static int            simMarks, simNextMark;
+
+static uint8_t        simLight[256];   // What the detector saw, by uS
+static int            simLit;          // Lit uS from SIM_OFF_LAG to SIM_ON_LAG ago
+
+unsigned long  simLedAt[SIM_LED_EDGES];  // When the LED changed [on first]
+int            simLedEdges;
+static bool           simLed;
+
+//+=============================================================================
+// Timer2's period in clocks, as it is set now
+//
+static unsigned long  simPeriod ( )
+{
+	static const unsigned int  prescale[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+
+	if (TCCR2B & _BV(WGM22))  return 2UL * OCR2A ;  // Phase-correct PWM, the carrier
+	return (unsigned long)prescale[TCCR2B & 7] * (OCR2A ? OCR2A : 256);
+}
+
+//+=============================================================================
+// One uS of the Nano
+//
+static void  simStep (unsigned long t)
+{
+	bool  led   = TCCR2A & _BV(COM2B1);
+	bool  light;
+	bool  low, was;
+
+	// The LED
+	if (led != simLed) {
+		if (simLedEdges < SIM_LED_EDGES)  simLedAt[simLedEdges++] = t ;
+		simLed = led;
+	}
+
+	// What the detector sees, and what it tells the pin
+	while ((simNextMark < simMarks) && (simMark[simNextMark][1] <= t))  simNextMark++ ;
+	light = (simNextMark < simMarks) && (simMark[simNextMark][0] <= t);
+	light = light || (simEcho && led);
+
+	simLight[t & 0xFF] = light;
+	simLit += simLight[(t - SIM_ON_LAG) & 0xFF] - simLight[(t - SIM_OFF_LAG) & 0xFF];
+	low = (simLit > 0);  // Light in the last SIM_ON_LAG to SIM_OFF_LAG uS
+	was = !(PINB & _BV(digitalPinToPCMSKbit(11)));
+	if (low != was) {
+		PINB ^= _BV(digitalPinToPCMSKbit(11));
+#if IR_RECV_EDGE && defined(IR_RECV_PCINT)
+		if (PCMSK0 & _BV(digitalPinToPCMSKbit(11)))  IR_RECV_PCINT() ;
+#endif
+	}
+
+	// Timer2
+#if SIM_TIMER
+	if (TIMSK2 & _BV(OCIE2A)) {
+		simClocks += SIM_CLOCKS;
+		while ((TIMSK2 & _BV(OCIE2A)) && simPeriod() && (simClocks >= simPeriod())) {
+			simClocks -= simPeriod();
+			simIsrs++;
+			TIMER_INTR_NAME();
+		}
+	} else {
+		simClocks = 0;
+	}
+#endif
+}
+
+//+=============================================================================
+// micros() has moved on : Catch up with it
+//
+static void  simHook (unsigned long usec)
+{
+	simTarget = usec;
+	if (simBusy)  return ;
+
+	simBusy = true;
+	while ((long)(simTarget - simNow) > 0)  simStep(++simNow) ;
+	simBusy = false;
+}
+
+//+=============================================================================
+// Stop the clock, idle, and start simulating
+//
+void  simStart ( )
+{
+	PINB = 0xFF;
+	setMicros(0);
+	simNow = simTarget = 0;
+	clockHook = simHook;
+}
+
+//+=============================================================================
+// Let usec go by
+//
+void  simRun (unsigned long usec)
+{
+	unsigned long  start = micros();
+
+	while (micros() - start < usec) ;
+}
+
+//+=============================================================================
+// The remote sends a frame at 'at', MARK first; Returns when it ends
+//
+unsigned long  simRemote (unsigned long at,  const unsigned int *usec,  int len)
+{
+	for (int i = 0;  i < len;  i++) {
+		if (!(i & 1) && usec[i] && (simMarks < SIM_MARKS)) {
+			simMark[simMarks][0]   = at;
+			simMark[simMarks++][1] = at + usec[i];
+		}
+		at += usec[i];
+	}
+	return at;
+}
+
+//+=============================================================================
+// The LED's MARKs and SPACEs since edge 'from' [its first MARK], in uS
+//
+int  simWave (int from,  unsigned long *usec,  int max)
+{
+	int  len = 0;
+
+	for (int i = from + 1;  (i < simLedEdges) && (len < max);  i++)  usec[len++] = simLedAt[i] - simLedAt[i - 1] ;
+	return len;
+}
+
+#endif // sim_h
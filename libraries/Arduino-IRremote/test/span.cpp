@@ -0,0 +1,148 @@
+//******************************************************************************
+// Span test : decodeSpan() on a copy of the durations decodes every frame just
+// as decode() does on the capture slot the ISR filled
+//
+// Each IRbench capture, as it is and with jitter, is put in a capture slot as
+// the ISR would and decoded with decode(), then the same durations are
+// decoded from a copy with decodeSpan() : In ticks, in half ticks [tick 25]
+// and in uS [tick 1].  Each gets an IRrecv of its own, so each has the same
+// protocol to try first.  Every field of decode_results must agree, and the
+// view must read the same durations [make span, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+typedef
+	struct {
+		int8_t               type;    // What it should decode as
+		unsigned long        value;
+		const unsigned int  *timing;  // uS, as IRrecvDumpV2 prints them
+		uint8_t              len;
+	}
+capture_t;
+
+#include "../examples/IRbench/captures.h"
+
+#define PASSES      20   // Jittered copies of each capture
+#define JITTER_PCT  10
+
+#if IR_COMPACT_RAWBUF
+#	define VIEWS  2      // The other ticks need durations that do not fit a byte
+#else
+#	define VIEWS  4
+#endif
+
+IRrecv  irrecv(11);
+IRrecv  spanrecv[3] = {IRrecv(11), IRrecv(11), IRrecv(11)};  // One per view
+
+static const uint8_t  ticks[VIEWS] = {USECPERTICK, USECPERTICK
+#if !IR_COMPACT_RAWBUF
+                                      , USECPERTICK / 2, 1
+#endif
+};
+
+//+=============================================================================
+// Store one duration in a slot, the way the ISR does [see IRbench.ino]
+//
+static void  store (volatile irslot_t *slot,  unsigned int t)
+{
+#if IR_COMPACT_RAWBUF
+	if (t >= IR_RAW_ESCAPE) {
+		if (slot->rawlongs < IR_RAW_LONGS) {
+			slot->rawlong[slot->rawlongs] = t;
+			t = IR_RAW_ESCAPE + slot->rawlongs++;
+		} else {
+			t = IR_RAW_ESCAPE - 1;
+		}
+	}
+#endif
+	if (slot->rawlen < RAWBUF)  slot->rawbuf[slot->rawlen++] = t ;
+	else                        slot->overflow = true ;
+}
+
+//+=============================================================================
+// Do two decodes agree on everything?
+//
+static bool  same (const decode_results *a,  const decode_results *b)
+{
+	if ( (a->decode_type != b->decode_type) || (a->value != b->value) || (a->bits != b->bits)
+	    || (a->rawlen != b->rawlen) || (a->overflow != b->overflow) ) {
+		return false;
+	}
+	if (a->address != b->address)  return false ;
+#if IR_RESULT_BITS
+	if ((a->data.count != b->data.count) || !a->data.equals(&b->data))  return false ;
+#endif
+	for (int i = 0;  i < a->rawlen;  i++)  if (a->rawAt(i) != b->rawAt(i))  return false ;
+	return true;
+}
+
+//+=============================================================================
+int  main ( )
+{
+	int  frames = 0, hashed = 0, wrong = 0;
+
+	randomSeed(1);
+
+	for (unsigned int c = 0;  c < CAPTURES;  c++) {
+		const capture_t  *cap = &captures[c];
+
+		for (int pass = 0;  pass <= PASSES;  pass++) {
+			volatile irslot_t  *slot = &irparams.slot[IR_SLOT(irparams.head)];
+			static irslot_t     copy;
+			static irraw_t      buf[VIEWS][RAWBUF];
+			decode_results      slotted, spanned;
+			bool                decoded;
+
+			// The slot, as the ISR leaves it [the first pass without jitter]
+			slot->rawlen   = 0;
+			slot->overflow = false;
+#if IR_COMPACT_RAWBUF
+			slot->rawlongs = 0;
+#endif
+#if IR_RECV_STREAM
+			slot->streamed = false;
+#endif
+			store(slot, 1000);  // The gap before it [50mS]
+			for (int i = 0;  i < cap->len;  i++) {
+				unsigned int  t = cap->timing[i] / USECPERTICK;
+
+				if (pass)  t += (long)t * random(-JITTER_PCT, JITTER_PCT + 1) / 100 ;
+				store(slot, t);
+			}
+			copy = *(irslot_t *)slot;
+			irparams.head++;
+
+			// Its durations, in each view's ticks
+			for (int v = 0;  v < VIEWS;  v++) {
+				for (int i = 0;  i < copy.rawlen;  i++) {
+					buf[v][i] = (v == 0) ? copy.rawbuf[i] : (irraw_t)(copy.rawbuf[i] * (USECPERTICK / ticks[v]));
+				}
+			}
+
+			decoded = irrecv.decode(&slotted);
+
+			for (int v = 1;  v < VIEWS;  v++) {
+				bool  ok;
+
+#if IR_COMPACT_RAWBUF
+				spanned.rawlong = copy.rawlong;
+#endif
+				ok = spanrecv[v - 1].decodeSpan(&spanned, buf[v], copy.rawlen, ticks[v]);
+				frames++;
+				if (decoded && (slotted.decode_type == UNKNOWN))  hashed++ ;
+				if ((ok != decoded) || (decoded && !same(&slotted, &spanned))) {
+					printf("%2u pass %2d tick %2u : decode() type %2d value %8lX bits %2d, decodeSpan() %s type %2d value %8lX bits %2d\n",
+					       c, pass, ticks[v], slotted.decode_type, (unsigned long)(uint32_t)slotted.value, slotted.bits,
+					       ok ? "decoded" : "failed", spanned.decode_type, (unsigned long)(uint32_t)spanned.value, spanned.bits);
+					wrong++;
+				}
+			}
+			if (decoded)  irrecv.resume() ;
+		}
+	}
+
+	printf("decodeSpan() : %d of %d frames decoded the same as decode() [%d only hashed; %d views]\n",
+	       frames - wrong, frames, hashed, VIEWS - 1);
+	return wrong ? 1 : 0;
+}
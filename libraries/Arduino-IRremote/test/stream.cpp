@@ -0,0 +1,115 @@
+//******************************************************************************
+// Stream test : With the protocol locked, the ISR decodes a frame as it comes
+// in, and decode() has it as soon as its last MARK ends [IR_RECV_STREAM]
+//
+// On the virtual Timer2 of sim.h, each IRbench capture is sent with its own
+// protocol locked, and decode() polled every 10uS.  The latency is from the
+// end of the frame's last MARK to decode() having it.
+//   Built with IR_RECV_STREAM, the protocols that can stream [a header and a
+//   fixed length : NEC and its REPEAT, Samsung, LG, Panasonic] must be decoded
+//   within STREAM_LATENCY uS, the detector's lag included; The others, and
+//   every frame without it, after the _GAP that ends them.
+//   A Samsung frame streamed before the lock moves to NEC must still decode
+//   as Samsung [as decode() gets to it after lockProtocol(NEC)].
+// Every frame must decode as captured.  Prints the latency of each [make
+// stream, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+#include "sim.h"
+
+typedef
+	struct {
+		int8_t               type;    // What it should decode as
+		unsigned long        value;
+		const unsigned int  *timing;  // uS, as IRrecvDumpV2 prints them
+		uint8_t              len;
+	}
+capture_t;
+
+#include "../examples/IRbench/captures.h"
+
+#define STREAM_LATENCY  (SIM_OFF_LAG + 2 * USECPERTICK + 100)  // The pin, a tick, and decode()
+#define SAMSUNG_CAPTURE 3
+
+IRrecv          irrecv(11);
+decode_results  results;
+
+//+=============================================================================
+// Can the ISR stream this protocol?
+//
+static bool  streams (int type)
+{
+	return IR_RECV_STREAM && ((type == NEC) || (type == SAMSUNG) || (type == LG) || (type == PANASONIC));
+}
+
+//+=============================================================================
+// Send the capture at 'at'; Returns when its last MARK ends
+//
+static unsigned long  send (unsigned long at,  const capture_t *cap)
+{
+	return simRemote(at, cap->timing, cap->len);
+}
+
+//+=============================================================================
+int  main ( )
+{
+	unsigned long  end, t;
+	bool           ok = true;
+
+	simStart();
+	irrecv.enableIRIn();
+	simRun(50000);
+
+	printf("IR_RECV_STREAM %d :\n", IR_RECV_STREAM);
+	for (unsigned int c = 0;  c < CAPTURES;  c++) {
+		const capture_t  *cap  = &captures[c];
+		long              lat  = -1;
+		bool              same = false;
+
+		irrecv.lockProtocol((decode_type_t)cap->type);
+		end = send(micros() + 1000, cap);
+
+		while ((t = micros()) < end + 50000) {
+			simRun(10);
+			if (!irrecv.decode(&results))  continue ;
+
+			if (lat < 0) {
+				lat  = t + 10 - end;
+				same = (results.decode_type == cap->type);
+				if (cap->type != UNKNOWN)  same = same && ((uint32_t)results.value == (uint32_t)cap->value) ;
+			}
+			irrecv.resume();
+		}
+
+		printf("  %2u type %2d : %s", c, cap->type, (lat < 0) ? "not decoded" : same ? "as captured" : "NOT AS CAPTURED");
+		if (lat >= 0)  printf(", %5ld uS after its last MARK%s", lat, streams(cap->type) ? " [streamed]" : "") ;
+		printf("\n");
+
+		if (!same)  ok = false ;
+		if (streams(cap->type) ? (lat > STREAM_LATENCY) : (lat < _GAP))  ok = false ;
+	}
+
+#if IR_RECV_STREAM
+	// Streamed as Samsung, and the lock moved on before decode() looked
+	{
+		const capture_t  *cap = &captures[SAMSUNG_CAPTURE];
+
+		irrecv.lockProtocol(SAMSUNG);
+		end = send(micros() + 1000, cap);
+		simRun(end + STREAM_LATENCY - micros());
+		irrecv.lockProtocol(NEC);
+
+		if (!irrecv.decode(&results) || (results.decode_type != SAMSUNG) || ((uint32_t)results.value != cap->value)) {
+			printf("  A Samsung frame streamed before lockProtocol(NEC) was not decoded as Samsung\n");
+			ok = false;
+		} else {
+			printf("  A Samsung frame streamed before lockProtocol(NEC) decoded as Samsung\n");
+		}
+		irrecv.resume();
+	}
+#endif
+
+	printf("  %s\n", ok ? "As expected" : "FAILED");
+	return ok ? 0 : 1;
+}
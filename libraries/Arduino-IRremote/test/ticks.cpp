@@ -0,0 +1,74 @@
+//******************************************************************************
+// Ticks test : The integer tick windows accept what the floating-point ones
+// they replaced did
+//
+// The old TICKS_LOW() and TICKS_HIGH() scaled by LTOL and UTOL in doubles.
+// For every duration a decoder can ask for, MARK_EXCESS either way, the
+// integer windows must be the same; And MATCH(), MATCH_MARK(), MATCH_SPACE()
+// and MATCH_TICKS() on a MARK_TICKS() or SPACE_TICKS() table entry must answer
+// as the old MATCH() did, for every count of ticks in and around the window.
+// Prints the first difference of each kind [make ticks, see the Makefile].
+//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+#define OLD_LTOL        (1.0 - (TOLERANCE/100.))
+#define OLD_UTOL        (1.0 + (TOLERANCE/100.))
+#define OLD_LOW(us)     ((int)(((us)*OLD_LTOL/USECPERTICK)))
+#define OLD_HIGH(us)    ((int)(((us)*OLD_UTOL/USECPERTICK + 1)))
+
+#define MAX_US  65535L  // The longest duration a decoder asks for
+
+// With constant arguments the windows are constants
+static const irticks_t  nec = MARK_TICKS(9000);
+static_assert(TICKS_HIGH(9000 + MARK_EXCESS) == 228, "TICKS_HIGH() does not fold");
+
+//+=============================================================================
+// The old MATCH(), with the windows in doubles
+//
+static bool  oldMatch (int measured,  long desired)
+{
+	return (measured >= OLD_LOW(desired)) && (measured <= OLD_HIGH(desired));
+}
+
+//+=============================================================================
+static bool  differs (const char *what,  long us,  int measured,  int want,  int got,  long *count)
+{
+	if (want == got)  return false ;
+	if (!(*count)++)  printf("%s at %ld uS, %d ticks : %d, was %d\n", what, us, measured, got, want);
+	return true;
+}
+
+//+=============================================================================
+int  main ( )
+{
+	long  windows = 0,  matches = 0,  tables = 0,  tried = 0;
+
+	// The windows themselves, as MATCH_SPACE() shifts them below 0 too
+	for (long us = -MARK_EXCESS;  us <= MAX_US + MARK_EXCESS;  us++) {
+		differs("TICKS_LOW",  us, 0, OLD_LOW(us),  TICKS_LOW(us),  &windows);
+		differs("TICKS_HIGH", us, 0, OLD_HIGH(us), TICKS_HIGH(us), &windows);
+	}
+
+	// Every count from below the window to above it
+	for (long us = 0;  us <= MAX_US;  us++) {
+		irticks_t  mark  = MARK_TICKS(us);
+		irticks_t  space = SPACE_TICKS(us);
+
+		for (int m = OLD_LOW(us - MARK_EXCESS) - 2;  m <= OLD_HIGH(us + MARK_EXCESS) + 2;  m++) {
+			tried++;
+			differs("MATCH",       us, m, oldMatch(m, us),               MATCH(m, us),       &matches);
+			differs("MATCH_MARK",  us, m, oldMatch(m, us + MARK_EXCESS), MATCH_MARK(m, us),  &matches);
+			differs("MATCH_SPACE", us, m, oldMatch(m, us - MARK_EXCESS), MATCH_SPACE(m, us), &matches);
+			if (m < 0)  continue ;
+
+			// Table windows are unsigned : Only SPACEs of MARK_EXCESS or more fit them
+			differs("MARK_TICKS", us, m, oldMatch(m, us + MARK_EXCESS), MATCH_TICKS(m, mark), &tables);
+			if (us >= MARK_EXCESS)  differs("SPACE_TICKS", us, m, oldMatch(m, us - MARK_EXCESS), MATCH_TICKS(m, space), &tables) ;
+		}
+	}
+
+	printf("0..%ld uS, %ld tick counts [NEC's header MARK is %u..%u ticks] : %ld window, %ld MATCH, %ld table differences\n",
+	       MAX_US, tried, nec.lo, nec.hi, windows, matches, tables);
+	return (windows || matches || tables) ? 1 : 0;
+}
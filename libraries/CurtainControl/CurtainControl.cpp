@@ -110,10 +110,17 @@ void CurtainControl::read_settings() {
 }
 
 // This takes some time to do.
+// The learned remote templates go too: they report the codes the remote
+// settings held, so they would otherwise outlive the buttons they stood for.
 void CurtainControl::reset_settings() {
 	for (int i = SETTINGS_ADDR; i < SETTINGS_END_ADDR; i++) {
 		EEPROM.write(i, 0);
 	}
+#if REMOTE_TEMPLATES
+	for (int i = TEMPLATES_ADDR; i < TEMPLATES_ADDR + TEMPLATE_SLOTS * (int)sizeof(RemoteTemplate); i++) {
+		EEPROM.write(i, 0);
+	}
+#endif
 }
 
 
@@ -92,7 +92,7 @@ public:
 	// settings
 	void trigger_write(); // Triggers the delayed write (call this one)
 	void read_settings(); // Reads settings into local memory
-	void reset_settings(); // Clear the entire EEPROM
+	void reset_settings(); // Clear the settings and the learned remote templates from EEPROM
 	Settings settings; // Modified in-place, then written manually
 	const SettingsAddresses settings_addr; // Address specs
 
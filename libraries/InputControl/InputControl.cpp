@@ -7,6 +7,8 @@ Date: 05/12/2017
 */
 
 #include "InputControl.h"
+#include <stddef.h>
+#include <util/crc16.h>
 
 /*
 ====================
@@ -100,6 +102,10 @@ void UserInputControl::init() {
 	pinMode(close_pin, INPUT);
 	pinMode(ir_pin, INPUT);
 
+#if REMOTE_TEMPLATES
+	templates.init();
+#endif
+
 	DBG_PRINTLN("UserInputControl: Enabling IRin");
 	remote.enableIRIn(); // Start the receiver's interrupt loop
 	DBG_PRINTLN("UserInputControl: Enabled IRin");
@@ -113,12 +119,36 @@ void UserInputControl::poll() {
 
 	// Check the remote,
 	// The first pressed button will be present in the results register.
-	// We only resume listening if the output is retrieved.
-	if(remote.decode(&remote_results)) {
-		latest_signal = remote_results.value;
-		new_signal_trigger = true;
-		last_remote_signal_time = millis();
-		remote.resume();
+	// A capture matching a learned template needs no decoding at all.
+	// (decode() resumes listening by itself if it fails)
+	if (remote.capture(&remote_results)) {
+		long signal;
+		bool received = false;
+
+#if REMOTE_TEMPLATES
+		received = !learning && templates.match(remote_results, signal);
+#endif
+		if (!received && remote.decode(&remote_results)) {
+			signal = remote_results.value;
+#if REMOTE_TEMPLATES
+			if (learning) {
+				signal = templates.learn(remote_results, signal);
+			}
+#endif
+			received = true;
+		}
+
+		if (received) {
+			latest_signal = signal;
+			new_signal_trigger = true;
+			last_remote_signal_time = millis();
+			track_signal(signal, remote_results.stamp);
+			remote.resume();
+		}
+	} else if (held && millis() - held_last > REPEAT_TIMEOUT && remote.isIdle()) {
+		// Nothing waiting or arriving and the repeats have stopped, the button is up
+		push_event(REMOTE_RELEASE, held_code, held_last);
+		held = false;
 	}
 
 	// Set internal state
@@ -239,3 +269,327 @@ unsigned long UserInputControl::get_last_signal_time() {
 unsigned long UserInputControl::time_to_last_signal() {
 	return millis() - last_remote_signal_time;
 }
+
+/* REMOTE EVENTS */
+
+bool UserInputControl::new_event() {
+	poll();
+	return event_count > 0;
+}
+
+// Returns the oldest waiting event (check new_event() first)
+RemoteEvent UserInputControl::remote_event() {
+	RemoteEvent event = events[event_head];
+
+	if (event_count > 0) {
+		event_head = (event_head + 1) % REMOTE_EVENTS;
+		--event_count;
+	}
+	return event;
+}
+
+long UserInputControl::held_signal() {
+	poll();
+	return held ? held_code : 0;
+}
+
+unsigned long UserInputControl::held_time() {
+	poll();
+	return held ? millis() - held_start : 0;
+}
+
+// A held button sends REPEAT (NEC) or the same frame again (most others).
+// Either one within REPEAT_TIMEOUT of the last frame is a repeat of the
+// held button, anything else is a new press.
+void UserInputControl::track_signal(long signal, unsigned long time) {
+	bool repeat = held && time - held_last <= REPEAT_TIMEOUT
+		&& ((unsigned long)signal == REPEAT || signal == held_code);
+
+	if (repeat) {
+		push_event(REMOTE_REPEAT, held_code, time);
+		held_last = time;
+		return;
+	}
+
+	if (held) {
+		push_event(REMOTE_RELEASE, held_code, held_last);
+		held = false;
+	}
+
+	// A REPEAT without its press (the press was missed) can't be told apart
+	if ((unsigned long)signal == REPEAT) {
+		return;
+	}
+
+	push_event(REMOTE_PRESS, signal, time);
+	held = true;
+	held_code = signal;
+	held_start = time;
+	held_last = time;
+}
+
+void UserInputControl::push_event(RemoteEventType type, long signal, unsigned long time) {
+	if (event_count == REMOTE_EVENTS) {
+		// Full, drop the oldest
+		event_head = (event_head + 1) % REMOTE_EVENTS;
+		--event_count;
+	}
+
+	RemoteEvent &event = events[(event_head + event_count) % REMOTE_EVENTS];
+	event.type = type;
+	event.signal = signal;
+	event.time = time;
+	++event_count;
+}
+
+// Start learning templates for the buttons about to be recorded
+void UserInputControl::start_learning() {
+#if REMOTE_TEMPLATES
+	learning = true;
+#endif
+}
+
+void UserInputControl::stop_learning() {
+#if REMOTE_TEMPLATES
+	learning = false;
+#endif
+}
+
+// Stores the templates learned for the signal that was just recorded
+bool UserInputControl::save_learned(long signal) {
+#if REMOTE_TEMPLATES
+	return templates.save(signal);
+#else
+	return false;
+#endif
+}
+
+void UserInputControl::clear_learned() {
+#if REMOTE_TEMPLATES
+	templates.clear();
+#endif
+}
+
+
+#if REMOTE_TEMPLATES
+/*
+================
+REMOTE TEMPLATES
+================
+*/
+
+// Durations are compared in ticks, capped to fit a byte
+static uint8_t template_ticks(decode_results &results, int i) {
+	unsigned int ticks = results.rawAt(i);
+	return (ticks > 255) ? 255 : ticks;
+}
+
+// Within 25% (and a tick either way, for the short ones)
+static bool template_close(uint8_t measured, uint8_t length) {
+	unsigned int diff = (measured > length) ? (measured - length) : (length - measured);
+	return 4 * diff <= length + 4;
+}
+
+static int template_addr(uint8_t slot) {
+	return TEMPLATES_ADDR + slot * sizeof(RemoteTemplate);
+}
+
+// One byte of a template, from RAM if there is a copy there, else from EEPROM
+static uint8_t template_byte(const RemoteTemplate *t, uint8_t slot, size_t offset) {
+	return t ? ((const uint8_t *)t)[offset] : EEPROM.read(template_addr(slot) + offset);
+}
+
+void RemoteTemplates::init() {
+	RemoteTemplate t;
+
+	for (uint8_t slot = 0; slot < TEMPLATE_SLOTS; ++slot) {
+		EEPROM.get(template_addr(slot), t);
+		lens[slot] = (t.len != 0 && t.len <= TEMPLATE_DURATIONS && t.crc == crc(t)) ? t.len : 0;
+	}
+}
+
+// Finds the stored template closest to the capture.
+// Templates of another length are skipped without reading EEPROM, and each
+// one is given up on as soon as it is no better than the best so far. The one
+// that matched last is tried first, since a held button repeats.
+bool RemoteTemplates::match(decode_results &results, long &code) {
+	uint8_t best = TEMPLATE_MAX_MISSES + 1;
+	uint8_t best_slot = 0;
+
+	for (uint8_t n = 0; n < TEMPLATE_SLOTS && best != 0; ++n) {
+		uint8_t slot = (last_slot + n) % TEMPLATE_SLOTS;
+
+		if (lens[slot] != results.rawlen - 1) {
+			continue;
+		}
+
+		uint8_t misses = distance(NULL, slot, results, best - 1);
+		if (misses < best) {
+			best = misses;
+			best_slot = slot;
+		}
+	}
+
+	if (best > TEMPLATE_MAX_MISSES) {
+		return false;
+	}
+
+	EEPROM.get(template_addr(best_slot) + offsetof(RemoteTemplate, code), code);
+	last_slot = best_slot;
+	return true;
+}
+
+// While learning, a capture that matches a template seen earlier reports that
+// template's code, so a remote that never hashes the same twice can still be
+// recorded. Otherwise it is kept (up to TEMPLATE_VARIANTS for one button).
+long RemoteTemplates::learn(decode_results &results, long decoded) {
+	RemoteTemplate t;
+
+	if (!build(results, t)) {
+		return decoded; // Too many different lengths to make a template of
+	}
+
+	for (uint8_t i = 0; i < pending_count; ++i) {
+		if (distance(&pending[i], 0, results, TEMPLATE_MAX_MISSES) <= TEMPLATE_MAX_MISSES) {
+			return pending[i].code;
+		}
+	}
+
+	// A different button, start again
+	if (pending_count > 0 && pending[0].code != decoded) {
+		pending_count = 0;
+	}
+
+	if (pending_count < TEMPLATE_VARIANTS) {
+		t.code = decoded;
+		pending[pending_count++] = t;
+	}
+
+	return decoded;
+}
+
+// Writes the templates learned for code into free slots
+bool RemoteTemplates::save(long code) {
+	bool saved = false;
+
+	for (uint8_t i = 0; i < pending_count; ++i) {
+		if (pending[i].code != code) {
+			continue;
+		}
+
+		for (uint8_t slot = 0; slot < TEMPLATE_SLOTS; ++slot) {
+			if (lens[slot] == 0) {
+				pending[i].crc = crc(pending[i]);
+				EEPROM.put(template_addr(slot), pending[i]);
+				lens[slot] = pending[i].len;
+				saved = true;
+				break;
+			}
+		}
+	}
+
+	pending_count = 0;
+	return saved;
+}
+
+// Only the length is cleared, the rest then fails its CRC
+void RemoteTemplates::clear() {
+	for (uint8_t slot = 0; slot < TEMPLATE_SLOTS; ++slot) {
+		EEPROM.update(template_addr(slot) + offsetof(RemoteTemplate, len), 0);
+		lens[slot] = 0;
+	}
+	pending_count = 0;
+}
+
+// Sorts every mark, and every space, into one of TEMPLATE_CLASSES lengths.
+// Each length is the average of the durations sorted into it.
+bool RemoteTemplates::build(decode_results &results, RemoteTemplate &t) {
+	unsigned int sum[2][TEMPLATE_CLASSES] = {};
+	uint8_t count[2][TEMPLATE_CLASSES] = {};
+	uint8_t first[2][TEMPLATE_CLASSES] = {};
+	uint8_t used[2] = {0, 0};
+
+	if (results.rawlen < 6 || results.rawlen - 1 > TEMPLATE_DURATIONS) {
+		return false; // Noise, or too long to store
+	}
+
+	memset(&t, 0, sizeof(t));
+	t.len = results.rawlen - 1;
+
+	for (uint8_t i = 0; i < t.len; ++i) {
+		uint8_t ticks = template_ticks(results, i + 1);
+		uint8_t kind = i & 1; // 0 for a mark, 1 for a space
+		uint8_t c = 0;
+
+		// Close both ways, so the average stays close to every duration in the class
+		while (c < used[kind] && !(template_close(ticks, first[kind][c]) && template_close(first[kind][c], ticks))) {
+			++c;
+		}
+		if (c == used[kind]) {
+			if (c == TEMPLATE_CLASSES) {
+				return false;
+			}
+			first[kind][c] = ticks;
+			++used[kind];
+		}
+
+		sum[kind][c] += ticks;
+		++count[kind][c];
+		t.classes[i / 4] |= c << (2 * (i % 4));
+	}
+
+	for (uint8_t c = 0; c < TEMPLATE_CLASSES; ++c) {
+		if (count[0][c]) { t.mark[c] = sum[0][c] / count[0][c]; }
+		if (count[1][c]) { t.space[c] = sum[1][c] / count[1][c]; }
+	}
+
+	return true;
+}
+
+// Counts the durations that are not close to their template length.
+// Stops counting once there are more than limit.
+// The template is pending (in RAM) or, if that is NULL, the one in slot. That
+// is read from EEPROM a byte at a time, so a poor match costs few reads.
+uint8_t RemoteTemplates::distance(const RemoteTemplate *pending, uint8_t slot, decode_results &results, uint8_t limit) {
+	uint8_t lengths[2][TEMPLATE_CLASSES];
+	uint8_t classes = 0;
+	uint8_t misses = 0;
+	uint8_t len = pending ? pending->len : lens[slot];
+
+	if (len != results.rawlen - 1) {
+		return 255;
+	}
+
+	for (uint8_t c = 0; c < TEMPLATE_CLASSES; ++c) {
+		lengths[0][c] = template_byte(pending, slot, offsetof(RemoteTemplate, mark) + c);
+		lengths[1][c] = template_byte(pending, slot, offsetof(RemoteTemplate, space) + c);
+	}
+
+	// Backwards: buttons of one remote share their header and address, so
+	// a wrong one is usually given away by the last few durations
+	for (uint8_t i = len; i-- > 0; ) {
+		if (i % 4 == 3 || i == len - 1) {
+			classes = template_byte(pending, slot, offsetof(RemoteTemplate, classes) + i / 4);
+		}
+
+		uint8_t length = lengths[i & 1][(classes >> (2 * (i % 4))) & 3];
+
+		if (!template_close(template_ticks(results, i + 1), length) && ++misses > limit) {
+			break;
+		}
+	}
+
+	return misses;
+}
+
+uint16_t RemoteTemplates::crc(const RemoteTemplate &t) {
+	const uint8_t *bytes = (const uint8_t *)&t;
+	uint16_t crc = 0xFFFF;
+
+	for (size_t i = 0; i < offsetof(RemoteTemplate, crc); ++i) {
+		crc = _crc16_update(crc, bytes[i]);
+	}
+
+	return crc;
+}
+#endif
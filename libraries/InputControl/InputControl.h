@@ -16,6 +16,7 @@ Description:
 
 #include "Arduino.h"
 #include <IRremote.h>
+#include <EEPROM.h>
 
 // Allow the use of a debugging hook
 #ifndef DEBUGGING
@@ -40,6 +41,25 @@ Description:
 #define LIGHT_DEBOUNCE_GAP 4 // Gap between light readings before we recalculate state
 #define DAY_PHASE_DELAY 10*60*1000 // Time (10 mins) in ms between accepting a measured change in the current day phase
 
+// Learned remote templates (see RemoteTemplates)
+// Costs about 92 bytes of SRAM: 80 for the two templates being learned
+// (TEMPLATE_VARIANTS x 40) and 12 of bookkeeping. That is most of what
+// IR_COMPACT_RAWBUF saves on a capture slot, so turn it off if that saving
+// is needed elsewhere. The templates themselves live in EEPROM.
+#ifndef REMOTE_TEMPLATES
+#define REMOTE_TEMPLATES true // Match captures against learned templates before decoding them
+#endif
+#define TEMPLATES_ADDR 32 // EEPROM address of the first template (after the CurtainControl settings)
+#define TEMPLATE_SLOTS 10 // Number of templates kept in EEPROM
+#define TEMPLATE_VARIANTS 2 // Most templates learned for one button
+#define TEMPLATE_CLASSES 4 // Distinct mark lengths (and space lengths) a template can hold
+#define TEMPLATE_DURATIONS (RAWBUF - 1) // Most durations a template can hold
+#define TEMPLATE_MAX_MISSES 0 // Durations allowed outside tolerance in a match (one miss can be a different bit)
+
+// Remote events (see UserInputControl::remote_event)
+#define REPEAT_TIMEOUT 200 // ms without a frame before a held button counts as released (NEC repeats every 108ms)
+#define REMOTE_EVENTS 4 // Events kept until taken, the oldest are dropped first
+
 
 enum Button {
 	OPEN,
@@ -48,6 +68,19 @@ enum Button {
 	NONE
 };
 
+// What a remote button did. Holding one down is a press, repeats, then a release.
+enum RemoteEventType {
+	REMOTE_PRESS,
+	REMOTE_REPEAT,
+	REMOTE_RELEASE
+};
+
+struct RemoteEvent {
+	RemoteEventType type;
+	long signal; // The button's code, also for repeats (never REPEAT)
+	unsigned long time; // millis() as its frame began (for a release, the last frame seen)
+};
+
 // The day phases according to brightness
 enum Brightness {
 	DARK, // Low state, ready to go DUSK -> LIGHT
@@ -89,6 +122,45 @@ private:
 	unsigned long phase_wait_trigger; // Stores the time that we last recorded a DARK/LIGHT transition (for phase delay debouncing)
 };
 
+// A learned remote button: the timing of one capture, quantized.
+// Every mark is one of up to TEMPLATE_CLASSES lengths and so is every space,
+// so each duration is stored as a 2 bit class number.
+struct RemoteTemplate {
+	long code; // The signal reported when a capture matches
+	uint8_t len; // Number of durations (rawlen - 1). 0 for an empty slot.
+	uint8_t mark[TEMPLATE_CLASSES]; // Mark lengths in ticks (0 for unused)
+	uint8_t space[TEMPLATE_CLASSES]; // Space lengths in ticks (0 for unused)
+	uint8_t classes[(TEMPLATE_DURATIONS + 3) / 4]; // Class of each duration, 4 to a byte
+	uint16_t crc; // CRC16 of all of the above, checked when loading from EEPROM
+};
+
+// Keeps the learned templates in EEPROM and matches captures against them.
+// Matching only compares durations, so it works for any remote, including
+// the ones whose decodeHash() value isn't stable from press to press.
+class RemoteTemplates {
+public:
+	void init(); // Checks the CRC of every stored template
+
+	bool match(decode_results &results, long &code); // True (and the code) if the capture matches a stored template
+
+	// Learning
+	long learn(decode_results &results, long decoded); // Returns the code to report for a capture while learning
+	bool save(long code); // Stores the templates learned for code
+	void clear(); // Forgets every stored template
+
+private:
+	bool build(decode_results &results, RemoteTemplate &t); // Quantizes a capture
+	uint8_t distance(const RemoteTemplate *pending, uint8_t slot, decode_results &results, uint8_t limit); // Durations out of tolerance
+	uint16_t crc(const RemoteTemplate &t);
+
+	uint8_t lens[TEMPLATE_SLOTS]; // len of each stored template (0 if empty or corrupt)
+	uint8_t last_slot = 0; // The slot that matched last, tried first
+
+	// Templates seen since learning started for the button being recorded
+	RemoteTemplate pending[TEMPLATE_VARIANTS];
+	uint8_t pending_count = 0;
+};
+
 class UserInputControl {
 public:
 	UserInputControl(short open_pin, short close_pin, short home_pin, short ir_pin) : open_pin(open_pin), close_pin(close_pin), home_pin(home_pin), ir_pin(ir_pin), remote(ir_pin) {};
@@ -119,6 +191,18 @@ public:
 	unsigned long get_last_signal_time();
 	unsigned long time_to_last_signal();
 
+	// Remote events
+	bool new_event(); // True if a remote event is waiting
+	RemoteEvent remote_event(); // Takes the oldest waiting event
+	long held_signal(); // The signal of the button being held down (0 if none)
+	unsigned long held_time(); // ms the button has been held down for (0 if none)
+
+	// Learning the remote (no effect without REMOTE_TEMPLATES)
+	void start_learning(); // Learn templates from the signals received
+	void stop_learning();
+	bool save_learned(long signal); // Stores the templates learned for this signal
+	void clear_learned(); // Forgets every stored template
+
 private:
 	// Pins:
 	short open_pin;
@@ -141,6 +225,21 @@ private:
 	long latest_signal; // Store the latest remote signal
 	unsigned long last_remote_signal_time; // Store the last time a signal was received
 	decode_results remote_results; // Class for storing the results of an IR input
+
+	// For remote events:
+	void track_signal(long signal, unsigned long time); // Turns a received signal into events
+	void push_event(RemoteEventType type, long signal, unsigned long time);
+	RemoteEvent events[REMOTE_EVENTS]; // Waiting events, oldest at event_head
+	uint8_t event_head = 0;
+	uint8_t event_count = 0;
+	bool held = false; // True between a press and its release
+	long held_code; // The signal of the held button
+	unsigned long held_start; // When it was pressed
+	unsigned long held_last; // When its last frame began
+#if REMOTE_TEMPLATES
+	RemoteTemplates templates; // Learned buttons, tried before decoding
+	bool learning = false; // True while recording the remote
+#endif
 };
 
 #endif
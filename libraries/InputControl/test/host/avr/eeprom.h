@@ -0,0 +1,16 @@
+//******************************************************************************
+// Stand-in for avr/eeprom.h : The EEPROM of a Nano, as an array on the PC
+//******************************************************************************
+#ifndef _AVR_EEPROM_H_
+#define _AVR_EEPROM_H_
+
+#include <stdint.h>
+
+#define E2END  1023
+
+extern uint8_t  host_eeprom[E2END + 1];  // Defined by the test
+
+static inline uint8_t  eeprom_read_byte  (const uint8_t *p)        { return host_eeprom[(uintptr_t)p]; }
+static inline void     eeprom_write_byte (uint8_t *p,  uint8_t v)  { host_eeprom[(uintptr_t)p] = v; }
+
+#endif // _AVR_EEPROM_H_
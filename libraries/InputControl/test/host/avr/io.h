@@ -0,0 +1,4 @@
+//******************************************************************************
+// Stand-in for avr/io.h : Arduino.h has the registers already
+//******************************************************************************
+#include <Arduino.h>
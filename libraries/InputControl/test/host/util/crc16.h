@@ -0,0 +1,16 @@
+//******************************************************************************
+// Stand-in for util/crc16.h : The same CRC16 [polynomial 0xA001] in C
+//******************************************************************************
+#ifndef _UTIL_CRC16_H_
+#define _UTIL_CRC16_H_
+
+#include <stdint.h>
+
+static inline uint16_t  _crc16_update (uint16_t crc,  uint8_t a)
+{
+	crc ^= a;
+	for (int i = 0;  i < 8;  i++)  crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : (crc >> 1) ;
+	return crc;
+}
+
+#endif // _UTIL_CRC16_H_
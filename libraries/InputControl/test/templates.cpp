@@ -0,0 +1,162 @@
+// Host test of RemoteTemplates: learned templates against the IRbench captures.
+//
+// Each button is learned as record_remote() learns it, from four jittered
+// presses, and saved. The templates are then loaded back as after a restart,
+// and every capture is played PRESSES times at each jitter, through match()
+// first and decodeSpan() when it fails, as poll() does.
+// A learned button must match with its code (else a false reject), any other
+// capture must not match at all (else a false accept). The decoder is scored
+// the same way on its value, for comparison. Prints the rates and the time
+// per match and per decode, and fails on any false accept, or on a false
+// reject of a button pressed without jitter.
+// Build and run with make (see the Makefile).
+
+#include <InputControl.h>
+#include "IRremoteInt.h"
+
+uint8_t host_eeprom[E2END + 1];
+
+typedef
+	struct {
+		int8_t               type;    // What it should decode as
+		unsigned long        value;
+		const unsigned int  *timing;  // uS, as IRrecvDumpV2 prints them
+		uint8_t              len;
+	}
+capture_t;
+
+#include "../../Arduino-IRremote/examples/IRbench/captures.h"
+
+#define PRESSES 2000 // Of each capture, at each jitter
+#define LEARN_PRESSES 4
+
+// The captures learned as buttons: two of one NEC remote, three other
+// protocols, and the remote that only hashes. The rest must be rejected.
+static const int buttons[] = {0, 3, 4, 7, 13};
+#define BUTTONS (sizeof(buttons) / sizeof(buttons[0]))
+
+static IRrecv irrecv(11);
+static RemoteTemplates templates;
+static decode_results results;
+static irraw_t buf[RAWBUF];
+
+// A capture as the ISR leaves it, after a 50mS gap, with every duration
+// off by up to jitter percent either way
+static void press(const capture_t *cap, int jitter) {
+	int len = 0;
+
+	buf[len++] = 1000;
+	for (int i = 0; i < cap->len && len < RAWBUF; ++i) {
+		long ticks = cap->timing[i] / USECPERTICK;
+		ticks += (ticks * random(-jitter, jitter + 1) + 50) / 100;
+		buf[len++] = (ticks < 1) ? 1 : ticks;
+	}
+
+	// As capture() leaves it: the durations, not decoded
+	results.rawbuf = buf;
+	results.rawlen = len;
+	results.tick = USECPERTICK;
+	results.overflow = false;
+}
+
+// The button learned from the capture, if it is one
+static int button(int cap) {
+	for (unsigned int b = 0; b < BUTTONS; ++b) {
+		if (buttons[b] == cap) {
+			return b;
+		}
+	}
+	return -1;
+}
+
+int main() {
+	static const int jitters[] = {0, 5, 10, 15, 20};
+	long learned[BUTTONS];
+	bool ok = true;
+
+	randomSeed(1);
+	printf("%u buttons learned from %d presses, %d presses of each of %u captures per row\n",
+	       (unsigned int)BUTTONS, LEARN_PRESSES, PRESSES, (unsigned int)CAPTURES);
+	printf("              template                   decode\n");
+	printf("  jitter   FR      FA      nS         FR      FA      nS\n");
+
+	for (unsigned int j = 0; j < sizeof(jitters) / sizeof(jitters[0]); ++j) {
+		int jitter = jitters[j];
+		unsigned long matches = 0, decodes = 0;
+		unsigned long tfr = 0, tfa = 0, dfr = 0, dfa = 0, mine = 0, others = 0;
+		unsigned long matchNs = 0, decodeNs = 0;
+
+		// record_remote(), with the same jitter
+		memset(host_eeprom, 0xFF, sizeof(host_eeprom));
+		templates.init();
+		templates.clear();
+		for (unsigned int b = 0; b < BUTTONS; ++b) {
+			long code = 0;
+
+			for (int n = 0; n < LEARN_PRESSES; ++n) {
+				press(&captures[buttons[b]], jitter);
+				if (irrecv.decodeSpan(&results, buf, results.rawlen)) {
+					code = templates.learn(results, results.value);
+				}
+			}
+			templates.save(code);
+			learned[b] = code;
+		}
+		templates.init(); // As after a restart, through the CRC check
+
+		for (unsigned int c = 0; c < CAPTURES; ++c) {
+			int b = button(c);
+
+			for (int n = 0; n < PRESSES; ++n) {
+				unsigned long start;
+				bool matched, decoded;
+				long code = 0;
+
+				press(&captures[c], jitter);
+
+				start = nanos();
+				matched = templates.match(results, code);
+				matchNs += nanos() - start;
+				++matches;
+
+				start = nanos();
+				decoded = irrecv.decodeSpan(&results, buf, results.rawlen);
+				decodeNs += nanos() - start;
+				++decodes;
+
+				if (b >= 0) {
+					++mine;
+					if (!matched || code != learned[b]) {
+						++tfr;
+						if (!jitter) {
+							ok = false;
+						}
+					}
+					if (!decoded || (long)results.value != learned[b]) {
+						++dfr;
+					}
+				} else {
+					++others;
+					if (matched) {
+						++tfa;
+						ok = false;
+					}
+					for (unsigned int k = 0; decoded && k < BUTTONS; ++k) {
+						if ((long)results.value == learned[k]) {
+							++dfa;
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		printf("  +-%2d%%  %5.1f%%  %5.1f%%  %5lu      %5.1f%%  %5.1f%%  %5lu\n", jitter,
+		       100.0 * tfr / mine, 100.0 * tfa / others, matchNs / matches,
+		       100.0 * dfr / mine, 100.0 * dfa / others, decodeNs / decodes);
+	}
+
+	printf(ok ? "No false accepts, and every button pressed without jitter matched\n"
+	          : "FAILED: A false accept, or a button pressed without jitter did not match\n");
+	return ok ? 0 : 1;
+}
@@ -193,6 +193,10 @@ void record_remote() {
 
 	rgb_out.solid(1, 0, 0);	
 
+	// Learn a timing template of each button as well as its signal
+	input.clear_learned();
+	input.start_learning();
+
 	while (seq_num <= 5) {
 		if (input.new_signal()) {
 
@@ -245,6 +249,10 @@ void record_remote() {
 						break;
 				}
 
+				if (!input.save_learned(signal)) {
+					DBG_PRINTLN("No template saved, signal will be decoded");
+				}
+
 				signal_count = 0;
 			    last_signal = 0;
 
@@ -292,6 +300,7 @@ void record_remote() {
 		}
 	}
 
+	input.stop_learning();
 	rgb_out.off();
 
 	DBG_PRINTLN("Finished recording remote. Signals:");
@@ -313,15 +322,22 @@ void record_away() {
 	rgb_out.solid(0, 0, 1);
 	DBG_PRINTLN("Recording away position.");
 
+	// Forget anything pressed before we got here
+	while (input.new_event()) {
+		input.remote_event();
+	}
+
 	// Need to hold cancel on remote or buttons for SHORT_HOLD ms for this to exit
 	while (true) {
 
-		// Get signal from the remote
-		// Signals only last for a single loop
-		if (input.new_signal()) {
-			remote_signal = input.remote_signal();
-		} else {
-			remote_signal = 0;
+		// Get the button held down on the remote, it keeps moving until released.
+		// A press that was released before this loop still counts, once.
+		remote_signal = input.held_signal();
+		while (input.new_event()) {
+			RemoteEvent event = input.remote_event();
+			if (event.type == REMOTE_PRESS) {
+				remote_signal = event.signal;
+			}
 		}
 
 		if (input.open_pressed() || remote_open()) {
@@ -334,13 +350,16 @@ void record_away() {
 
 		if (input.both_pressed() && input.time_to_last_press() >= SHORT_HOLD) {
 			break;
-		} else if (remote_cancel() && input.time_to_last_signal() >= SHORT_HOLD) {
+		} else if (remote_cancel() && input.held_time() >= SHORT_HOLD) {
 			break;
 		}
 
 		curtain.poll();
 	}
 
+	// The main loop shouldn't act on the signals used here
+	input.remote_signal();
+
 	curtain.settings.away = curtain.get_location();
 	DBG_PRINT("Away position set: ");
 	DBG_PRINTLN(curtain.settings.away);